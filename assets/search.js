@@ -82,21 +82,25 @@ function updateSearchResults() {
         a.classList.add('panel-block');
         a.classList.add('is-family-code');
 
+        // Sharded pages are in a subdirectory named after the first two digits of their ID.
+        // Methods link to their record's page, whose ID is at the start of obj.id, so the same rule applies.
+        var dir = results.dataset.sharded === "true" ? obj.id.substring(0, 2) + "/" : "";
+
         // Method
         if (obj.type === 0) {
-            a.setAttribute("href", "r" + obj.id);
+            a.setAttribute("href", dir + "r" + obj.id);
         }
         // Function
         if (obj.type === 1) {
-            a.setAttribute("href", "f" + obj.id + ".html");
+            a.setAttribute("href", dir + "f" + obj.id + ".html");
         }
         // Class, struct, or union
         if (obj.type === 2 || obj.type === 3 || obj.type === 4) {
-            a.setAttribute("href", "r" + obj.id + ".html");
+            a.setAttribute("href", dir + "r" + obj.id + ".html");
         }
         // Enum or enum val
         if (obj.type === 5 || obj.type === 6) {
-            a.setAttribute("href", "e" + obj.id + ".html");
+            a.setAttribute("href", dir + "e" + obj.id + ".html");
         }
 
         var span = document.createElement("span");
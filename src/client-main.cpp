@@ -5,6 +5,8 @@
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 
+#include <fstream>
+
 #include "frontend/Frontend.hpp"
 #include "indexer/Indexer.hpp"
 #include "serde/Serialization.hpp"
@@ -34,9 +36,14 @@ int main(int argc, char** argv) {
   indexer.pruneTypeRefs();
   indexer.resolveNamespaces();
   indexer.updateRecordNames();
+  indexer.resolveReverseReferences();
+  indexer.computeFingerprints();
   indexer.printStats();
   const hdoc::types::Index* index = indexer.dump();
 
   const std::string data = hdoc::serde::serialize(*index, cfg);
+  if (cfg.archivePath != "") {
+    std::ofstream(cfg.archivePath, std::ios::binary) << data;
+  }
   hdoc::serde::uploadDocs(data);
 }
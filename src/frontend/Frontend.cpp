@@ -10,15 +10,15 @@
 #include <string>
 
 #include "frontend/Frontend.hpp"
+#include "support/SystemIncludes.hpp"
 
 #include "argparse.hpp"
+#include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/spdlog.h"
 #include "toml.hpp"
 #include "version.hpp"
-#include "llvm/Support/FileSystem.h"
-#include "llvm/Support/FileUtilities.h"
-#include "llvm/Support/Program.h"
-#include <llvm/Support/MemoryBuffer.h>
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Path.h"
 
 // These files are generated by meson at build-time using `xxd -i`
 extern uint8_t  ___site_content_oss_md[];   ///< Contents of the OSS attribution file
@@ -27,9 +27,63 @@ extern uint64_t ___site_content_oss_md_len; ///< Length of the OSS attribution f
 /// @brief Parse the CLI and configuration file
 hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* cfg) {
   cfg->hdocVersion = HDOC_VERSION;
+
+  // `hdoc diff OLD NEW` compares two archives instead of generating documentation
+  if (argc >= 2 && std::string_view(argv[1]) == "diff") {
+    argparse::ArgumentParser diff("hdoc diff", cfg->hdocVersion);
+    diff.add_argument("old").help("Archive of the old version of the project");
+    diff.add_argument("new").help("Archive of the new version of the project");
+    try {
+      diff.parse_args(argc - 1, argv + 1);
+    } catch (const std::runtime_error& err) {
+      spdlog::error("Error found while parsing command line arguments: {}", err.what());
+      return;
+    }
+    this->diffArchives = {diff.get<std::string>("old"), diff.get<std::string>("new")};
+    return;
+  }
+
+  // `hdoc serve` indexes the project in the current directory and serves its documentation, rendering pages on request
+  if (argc >= 2 && std::string_view(argv[1]) == "serve") {
+    argparse::ArgumentParser serve("hdoc serve", cfg->hdocVersion);
+    serve.add_argument("--port").help("Port to serve the documentation on").default_value(8000).scan<'i', int>();
+    serve.add_argument("--verbose").help("Whether to use verbose output").default_value(false).implicit_value(true);
+    try {
+      serve.parse_args(argc - 1, argv + 1);
+    } catch (const std::runtime_error& err) {
+      spdlog::error("Error found while parsing command line arguments: {}", err.what());
+      return;
+    }
+    spdlog::set_level(serve.get<bool>("--verbose") ? spdlog::level::info : spdlog::level::warn);
+
+    const int port = serve.get<int>("--port");
+    if (port <= 0 || port > 65535) {
+      spdlog::error("Port {} is invalid, it must be between 1 and 65535.", port);
+      return;
+    }
+    cfg->servePort = port;
+    cfg->rootDir   = std::filesystem::current_path();
+    loadConfigFile(cfg);
+    return;
+  }
+
   argparse::ArgumentParser program("hdoc", cfg->hdocVersion);
   program.add_argument("--verbose").help("Whether to use verbose output").default_value(false).implicit_value(true);
   program.add_argument("--oss").help("Show open source notices").default_value(false).implicit_value(true);
+  program.add_argument("--watch")
+      .help("Keep running and rebuild documentation when source files change")
+      .default_value(false)
+      .implicit_value(true);
+  program.add_argument("--archive")
+      .help("Also save the serialized index to this path, so it can be compared with `hdoc diff`")
+      .default_value(std::string(""));
+  program.add_argument("--output-archive")
+      .help("Write the documentation to this tar archive instead of the output directory, or to stdout if it's \"-\". "
+            "The archive is compressed with gzip if its name ends in .gz or .tgz")
+      .default_value(std::string(""));
+  program.add_argument("--batch")
+      .help("Generate documentation for each of the listed project directories, sharing resources between them")
+      .remaining();
 
   // Parse command line arguments
   try {
@@ -53,13 +107,70 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
     spdlog::set_level(spdlog::level::warn);
   }
 
+  cfg->watch = program.get<bool>("--watch");
+  if (cfg->watch && cfg->binaryType == hdoc::types::BinaryType::Client) {
+    spdlog::warn("--watch is only supported when saving documentation locally, ignoring it.");
+    cfg->watch = false;
+  }
+
+  const std::string archivePath = program.get<std::string>("--archive");
+  if (archivePath != "") {
+    cfg->archivePath = std::filesystem::absolute(archivePath);
+  }
+
+  const std::string outputArchive = program.get<std::string>("--output-archive");
+  if (outputArchive == "-") {
+    // Logs go to stderr instead, so that they don't end up in the middle of the archive
+    cfg->outputArchive = outputArchive;
+    spdlog::set_default_logger(spdlog::stderr_color_mt("stderr"));
+  } else if (outputArchive != "") {
+    cfg->outputArchive = std::filesystem::absolute(outputArchive);
+  }
+  if (cfg->outputArchive != "" && cfg->watch) {
+    spdlog::error("--output-archive and --watch can't be used together.");
+    return;
+  }
+
+  // In batch mode each project's configuration file is loaded separately, once the projects are processed
+  if (const auto dirs = program.present<std::vector<std::string>>("--batch")) {
+    if (cfg->binaryType == hdoc::types::BinaryType::Client) {
+      spdlog::error("--batch is only supported when saving documentation locally.");
+      return;
+    }
+    if (cfg->watch) {
+      spdlog::error("--watch and --batch can't be used together.");
+      return;
+    }
+    if (cfg->archivePath != "") {
+      spdlog::error("--archive and --batch can't be used together.");
+      return;
+    }
+    if (cfg->outputArchive != "") {
+      spdlog::error("--output-archive and --batch can't be used together.");
+      return;
+    }
+    for (const auto& dir : *dirs) {
+      this->batchDirs.push_back(std::filesystem::absolute(dir).lexically_normal());
+    }
+    return;
+  }
+
   // Check that the current directory contains a .hdoc.toml file
   cfg->rootDir = std::filesystem::current_path();
+  loadConfigFile(cfg);
+}
+
+void hdoc::frontend::Frontend::loadConfigFile(hdoc::types::Config* cfg) {
   if (!std::filesystem::is_regular_file(cfg->rootDir / ".hdoc.toml")) {
-    spdlog::error("Current directory doesn't contain an .hdoc.toml file.");
+    spdlog::error("{} doesn't contain an .hdoc.toml file.", cfg->rootDir.string());
     return;
   }
 
+  // Relative paths in the configuration file are relative to the directory it's in
+  const auto resolvePath = [&](const std::filesystem::path& p) {
+    return p.empty() || p.is_absolute() ? p : (cfg->rootDir / p).lexically_normal();
+  };
+
   // Parse configuration file
   toml::table toml;
   try {
@@ -74,7 +185,7 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
   }
 
   // Check that buildDir is a directory and contains a compile_commands.json file
-  cfg->compileCommandsJSON = std::filesystem::path(toml["paths"]["compile_commands"].value_or(""));
+  cfg->compileCommandsJSON = resolvePath(toml["paths"]["compile_commands"].value_or(""));
   if (std::filesystem::is_regular_file(cfg->compileCommandsJSON) == false) {
     spdlog::error("{} is not a valid file.", cfg->compileCommandsJSON.string());
     return;
@@ -94,7 +205,8 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
   }
 
   // Get other arguments from the .hdoc.toml file.
-  cfg->outputDir      = std::filesystem::path(toml["paths"]["output_dir"].value_or(""));
+  cfg->outputDir      = resolvePath(toml["paths"]["output_dir"].value_or(""));
+  cfg->shardPages     = toml["paths"]["shard_pages"].value_or(false);
   cfg->projectName    = toml["project"]["name"].value_or("");
   cfg->projectVersion = toml["project"]["version"].value_or("");
   cfg->gitRepoURL     = toml["project"]["git_repo_url"].value_or("");
@@ -127,79 +239,86 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
     cfg->numThreads = rawNumThreads;
   }
 
-  // Determine the compiler's builtin include paths and add them to the list
-  cfg->useSystemIncludes = toml["includes"]["use_system_includes"].value_or(true);
-  if (cfg->useSystemIncludes == true) {
-    llvm::SmallString<64> tempFile;
-    if (const auto ec = llvm::sys::fs::createTemporaryFile("hdoc-system-includes-compiler-output", "", tempFile)) {
-      spdlog::error("Unable to create temporary directory to store system includes: {}.", ec.message());
+  // renderThreads is validated the same way, with 0 meaning that pages are written using the indexing threads
+  if (toml["project"]["render_threads"].type() != toml::node_type::integer &&
+      toml["project"]["render_threads"].type() != toml::node_type::none) {
+    spdlog::error("Number of render threads in .hdoc.toml is not an integer.");
+    return;
+  }
+  if (toml["project"]["render_threads"].type() == toml::node_type::none) {
+    cfg->renderThreads = 0;
+  } else {
+    int64_t rawRenderThreads = toml["project"]["render_threads"].as_integer()->get();
+    if (rawRenderThreads < 0) {
+      spdlog::error("Number of render threads must be a positive integer greater than or equal to 0.");
       return;
     }
-    llvm::FileRemover tempFileRemove(tempFile);
+    cfg->renderThreads = rawRenderThreads;
+  }
 
-    // Try to find the default system C++ compiler.
-    const auto compilerPath = llvm::sys::findProgramByName("c++");
-    if (!compilerPath) {
-      spdlog::error("Unable to find system default C++ compiler to find system includes.");
+  // Determine the compiler's builtin include paths and add them to the list.
+  // If they're derived from each compile command instead, the indexer takes care of it.
+  cfg->useSystemIncludes   = toml["includes"]["use_system_includes"].value_or(true);
+  cfg->perTUSystemIncludes = toml["includes"]["per_tu_system_includes"].value_or(false);
+  if (cfg->useSystemIncludes == true && cfg->perTUSystemIncludes == false) {
+    const auto includePaths = hdoc::utils::getSystemIncludePaths({"c++", {}});
+    if (!includePaths) {
       return;
     }
+    cfg->includePaths.insert(cfg->includePaths.end(), includePaths->begin(), includePaths->end());
+  }
 
-    // The following flags make the compiler dump its default include paths.
-    // This works on all clang and gcc versions we've tried, but it might break with a more exotic compiler.
-    // The actual output we care about goes to tempFile, and we use /dev/null as a stand-in for the file the compiler
-    // reads.
-    llvm::SmallVector<llvm::StringRef> compilerFlags = {compilerPath.get(), "-E", "-Wp,-v", "-xc++", "/dev/null"};
-    llvm::Optional<llvm::StringRef>    redirects[]   = {llvm::None, {"/dev/null"}, {tempFile}}; // stdin, stdout, stderr
-
-    std::string errMsg = "";
-    int rc = llvm::sys::ExecuteAndWait(compilerPath.get(), compilerFlags, llvm::None, redirects, 10, 0, &errMsg);
-    if (rc != 0) {
-      spdlog::error("Failed to determine the system include paths ({}, {}).", rc, errMsg);
-      return;
+  // Get additional include paths from toml config file
+  if (const auto& includes = toml["includes"]["paths"].as_array()) {
+    for (const auto& inc : *includes) {
+      std::string s = inc.value_or(std::string(""));
+      if (s == "") {
+        spdlog::warn("An include path from .hdoc.toml was malformed, ignoring it.");
+        continue;
+      }
+      cfg->includePaths.push_back(resolvePath(s).string());
     }
+  }
 
-    auto buf = llvm::MemoryBuffer::getFile(tempFile);
-    if (!buf) {
-      spdlog::error("Failed to read compiler's default include paths.");
-      return;
+  // Clang modules are cached in a directory that's shared by all translation units and kept between runs,
+  // so each module is only built once instead of once per translation unit.
+  cfg->moduleCachePath = resolvePath(toml["modules"]["cache_path"].value_or(""));
+  if (cfg->moduleCachePath == "") {
+    llvm::SmallString<256> cacheDir;
+    if (llvm::sys::path::cache_directory(cacheDir)) {
+      cfg->moduleCachePath = std::filesystem::path(cacheDir.str().str()) / "hdoc" / "modules";
+    } else {
+      cfg->moduleCachePath = std::filesystem::temp_directory_path() / "hdoc-modules";
     }
-
-    llvm::StringRef                    compilerOutput = buf->get()->getBuffer();
-    llvm::SmallVector<llvm::StringRef> lines;
-    compilerOutput.split(lines, "\n");
-
-    bool searchListFound = false;
-    for (const auto line : lines) {
-      // Keep looking if we haven't found the line that starts with  '#include "..." search starts here'.
-      if (searchListFound == false) {
-        searchListFound = line.contains("#include") && line.contains("search starts here:");
-      }
-
-      // If we have found the beginning of the include list, filter it to only lines that have include paths.
-      if (searchListFound == true) {
-        if (line.startswith(" ")) {
-          cfg->includePaths.push_back(std::string(line.trim()));
-        }
-      }
-
-      // Stop looking if we've found the end of the include list.
-      if (line.contains("End of search list.")) {
-        break;
+  }
+  if (const auto& prebuiltPaths = toml["modules"]["prebuilt_paths"].as_array()) {
+    for (const auto& p : *prebuiltPaths) {
+      std::string s = p.value_or(std::string(""));
+      if (s == "") {
+        spdlog::warn("A prebuilt module path from .hdoc.toml was malformed, ignoring it.");
+        continue;
       }
+      cfg->prebuiltModulePaths.push_back(resolvePath(s).string());
     }
   }
 
-  // Get additional include paths from toml config file
-  if (const auto& includes = toml["includes"]["paths"].as_array()) {
-    for (const auto& inc : *includes) {
-      std::string s = inc.value_or(std::string(""));
+  // Tag files let projects link to each other's documentation without indexing each other's code
+  if (const auto& tagFiles = toml["tags"]["import"].as_array()) {
+    for (const auto& t : *tagFiles) {
+      std::string s = t.value_or(std::string(""));
       if (s == "") {
-        spdlog::warn("An include path from .hdoc.toml was malformed, ignoring it.");
+        spdlog::warn("A tag file path from .hdoc.toml was malformed, ignoring it.");
         continue;
       }
-      cfg->includePaths.push_back(s);
+      cfg->tagFiles.push_back(resolvePath(s));
     }
   }
+  cfg->tagFileExportPath = resolvePath(toml["tags"]["export"].value_or(""));
+  cfg->tagFileBaseURL    = toml["tags"]["base_url"].value_or("");
+  if (cfg->tagFileBaseURL != "" && cfg->tagFileBaseURL.back() != '/') {
+    spdlog::error("Tag file base URL is missing the mandatory trailing slash: {}", cfg->tagFileBaseURL);
+    return;
+  }
 
   // Get substrings of paths that should be ignored
   if (const auto& ignores = toml["ignore"]["paths"].as_array()) {
@@ -217,8 +336,26 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
     cfg->ignorePrivateMembers = ignorePrivateMembers;
   }
 
+  // In public API mode only symbols declared in headers under the public API roots are indexed
+  cfg->publicAPIOnly = toml["ignore"]["public_api_only"].value_or(false);
+  if (const auto& roots = toml["ignore"]["public_api_roots"].as_array()) {
+    for (const auto& r : *roots) {
+      std::string s = r.value_or(std::string(""));
+      if (s == "") {
+        spdlog::warn("A public API root from .hdoc.toml was malformed, ignoring it.");
+        continue;
+      }
+      // Symlinks are resolved so the roots can be compared with the canonical paths of decls
+      auto root = std::filesystem::weakly_canonical(resolvePath(s));
+      cfg->publicAPIRoots.push_back(root.has_filename() ? root : root.parent_path());
+    }
+  }
+  if (cfg->publicAPIOnly && cfg->publicAPIRoots.size() == 0) {
+    cfg->publicAPIRoots.push_back(std::filesystem::weakly_canonical(cfg->rootDir));
+  }
+
   // Collect paths to markdown files
-  cfg->homepage = std::filesystem::path(toml["pages"]["homepage"].value_or(""));
+  cfg->homepage = resolvePath(toml["pages"]["homepage"].value_or(""));
   if (const auto& mdPaths = toml["pages"]["paths"].as_array()) {
     for (const auto& md : *mdPaths) {
       std::string s = md.value_or(std::string(""));
@@ -226,7 +363,7 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
         spdlog::warn("A path to a markdown file in .hdoc.toml was malformed, ignoring it.");
         continue;
       }
-      std::filesystem::path mdPath(s);
+      std::filesystem::path mdPath = resolvePath(s);
       if (std::filesystem::exists(mdPath) == false || std::filesystem::is_regular_file(mdPath) == false) {
         spdlog::warn("A path to a markdown file in .hdoc.toml either doesn't exist or isn't a file, ignoring it.");
         continue;
@@ -241,25 +378,43 @@ hdoc::frontend::Frontend::Frontend(int argc, char** argv, hdoc::types::Config* c
   // development. It is not intended for use in production, only in bring-up.
   cfg->debugLimitNumIndexedFiles = toml["debug"]["limit_num_indexed_files"].value_or(0);
 
-  // Get the current timestamp
-  const auto        time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  std::stringstream ss;
-  ss << std::put_time(std::gmtime(&time_t), "%FT%T UTC");
-  cfg->timestamp = ss.str();
+  // Every page's footer would change on every run if it said when it was generated, so the timestamp is only added
+  // if it's reproducible, i.e. if it's given by SOURCE_DATE_EPOCH.
+  // See https://reproducible-builds.org/specs/source-date-epoch/
+  if (const char* epoch = std::getenv("SOURCE_DATE_EPOCH"); epoch != nullptr && *epoch != '\0') {
+    char*             end    = nullptr;
+    const std::time_t time_t = std::strtoll(epoch, &end, 10);
+    if (*end != '\0') {
+      spdlog::warn("SOURCE_DATE_EPOCH isn't a number of seconds ('{}'). Leaving the timestamp out of the footer.",
+                   epoch);
+    } else {
+      std::stringstream ss;
+      ss << std::put_time(std::gmtime(&time_t), "%FT%T UTC");
+      cfg->timestamp = ss.str();
+    }
+  }
 
   cfg->initialized = true;
 
   // Dump state of the Config object
   spdlog::info("hdoc version: {}", cfg->hdocVersion);
-  spdlog::info("Timestamp: {}", cfg->timestamp);
+  if (cfg->timestamp != "") {
+    spdlog::info("Timestamp: {}", cfg->timestamp);
+  }
   spdlog::info("Root directory: {}", cfg->rootDir.string());
   if (cfg->binaryType != hdoc::types::BinaryType::Client) {
     spdlog::info("Output directory: {}", cfg->outputDir.string());
   }
+  if (cfg->outputArchive != "") {
+    spdlog::info("Output archive: {}", cfg->outputArchive.string());
+  }
   spdlog::info("Project name: {}", cfg->projectName);
   spdlog::info("Project version: {}", cfg->projectVersion);
   spdlog::info("Indexing using {} threads",
                cfg->numThreads == 0 ? std::string("all") : std::to_string(cfg->numThreads));
+  if (cfg->renderThreads != 0) {
+    spdlog::info("Rendering using {} threads", cfg->renderThreads);
+  }
   if (cfg->debugLimitNumIndexedFiles > 0) {
     spdlog::info("Only indexing {} files ", std::to_string(cfg->debugLimitNumIndexedFiles));
   }
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <filesystem>
+#include <vector>
+
 #include "types/Config.hpp"
 
 namespace hdoc::frontend {
@@ -10,5 +13,12 @@ namespace hdoc::frontend {
 class Frontend {
 public:
   Frontend(int argc, char** argv, hdoc::types::Config* cfg);
+
+  /// @brief Parse the .hdoc.toml file in cfg->rootDir into cfg, marking cfg as initialized if it's valid.
+  /// Relative paths in the file are resolved against cfg->rootDir.
+  static void loadConfigFile(hdoc::types::Config* cfg);
+
+  std::vector<std::filesystem::path> batchDirs;    ///< Project directories passed with --batch, if any
+  std::vector<std::filesystem::path> diffArchives; ///< The old and new archives passed to `hdoc diff`, if any
 };
 } // namespace hdoc::frontend
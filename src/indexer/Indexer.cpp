@@ -1,17 +1,26 @@
 // Copyright 2019-2022 hdoc
 // SPDX-License-Identifier: AGPL-3.0-only
 
+#include <algorithm>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "spdlog/spdlog.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 #include "clang/Tooling/ArgumentsAdjusters.h"
-#include "clang/Tooling/JSONCompilationDatabase.h"
 #include "clang/Tooling/Tooling.h"
 
 #include "indexer/Indexer.hpp"
+#include "indexer/MatcherUtils.hpp"
 #include "indexer/Matchers.hpp"
+#include "serde/TagFile.hpp"
+#include "support/IndexTables.hpp"
 #include "support/ParallelExecutor.hpp"
+#include "support/SystemIncludes.hpp"
+#include "support/TaskGroup.hpp"
 
 // Check if a symbol is a child of the given namespace
 static bool isChild(const hdoc::types::Symbol& ns, const hdoc::types::Symbol& s) {
@@ -21,16 +30,110 @@ static bool isChild(const hdoc::types::Symbol& ns, const hdoc::types::Symbol& s)
 void hdoc::indexer::Indexer::run() {
   spdlog::info("Starting indexing...");
 
+  // The compilation database is scanned lazily, so indexing can start before all of it has been read
   std::string err;
-  const auto  stx = clang::tooling::JSONCommandLineSyntax::AutoDetect;
-  const auto  cmpdb =
-      clang::tooling::JSONCompilationDatabase::loadFromFile(this->cfg->compileCommandsJSON.string(), err, stx);
-
-  if (cmpdb == nullptr) {
+  this->cmpdb = hdoc::indexer::StreamingCompilationDatabase::loadFromFile(this->cfg->compileCommandsJSON.string(), err);
+  if (this->cmpdb == nullptr) {
     spdlog::error("Unable to initialize compilation database ({})", err);
     return;
   }
 
+  // Load tag files of other projects so that references to their types can be linked to
+  this->tagFiles.clear();
+  for (const auto& path : this->cfg->tagFiles) {
+    auto tags = hdoc::serde::TagFile::load(path, err);
+    if (tags == nullptr) {
+      spdlog::warn("Unable to load tag file {} ({}). Proceeding without it.", path.string(), err);
+      continue;
+    }
+    spdlog::info("Loaded {} tags from {}.", tags->size(), path.string());
+    this->tagFiles.push_back(std::move(tags));
+  }
+
+  // Add include search paths to clang invocation
+  this->args.clear();
+  if (this->cfg->useSystemIncludes && this->cfg->perTUSystemIncludes) {
+    // Every compiler needs to be known up front, so the whole database has to be scanned first
+    if (this->cmpdb->scan(err) == false) {
+      spdlog::error("Unable to read compilation database ({})", err);
+      return;
+    }
+    this->args.push_back(this->getPerTUSystemIncludesAdjuster());
+  }
+  for (const std::string& d : cfg->includePaths) {
+    // Ignore include paths that don't exist
+    if (!std::filesystem::exists(d)) {
+      spdlog::warn("Include path {} does not exist. Proceeding without it.", d);
+      continue;
+    }
+    spdlog::info("Appending {} to list of include paths.", d);
+    this->args.push_back(clang::tooling::getInsertArgumentAdjuster(("-isystem" + d).c_str()));
+  }
+
+  this->runMatchers();
+}
+
+/// Returns the key that identifies which compiler probe a compile command's system include paths come from.
+static std::string getInvocationKey(const hdoc::utils::CompilerInvocation& invocation) {
+  std::string key = invocation.compiler;
+  for (const auto& flag : invocation.flags) {
+    key += "\t" + flag;
+  }
+  return key;
+}
+
+clang::tooling::ArgumentsAdjuster hdoc::indexer::Indexer::getPerTUSystemIncludesAdjuster() {
+  // Relative compiler paths are resolved against the directory of each file's compile command, which the adjuster
+  // isn't given, so it's remembered here
+  auto directories = std::make_shared<std::unordered_map<std::string, std::string>>();
+
+  // Find all of the distinct compilers, and the flags that affect their include paths, in the compilation database
+  std::vector<hdoc::utils::CompilerInvocation> invocations;
+  std::unordered_set<std::string>              seen;
+  for (const auto& cmd : this->cmpdb->getAllCompileCommands()) {
+    (*directories)[cmd.Filename] = cmd.Directory;
+    const auto invocation        = hdoc::utils::getCompilerInvocation(cmd.CommandLine, cmd.Directory);
+    if (invocation && seen.insert(getInvocationKey(*invocation)).second) {
+      invocations.push_back(*invocation);
+    }
+  }
+
+  // Probe each compiler once, in parallel. Each task writes only its own slot so no locking is needed.
+  std::vector<std::optional<std::vector<std::string>>> results(invocations.size());
+  hdoc::utils::TaskGroup                               tasks(this->pool);
+  for (std::size_t i = 0; i < invocations.size(); i++) {
+    tasks.async([&, i]() { results[i] = hdoc::utils::getSystemIncludePaths(invocations[i]); });
+  }
+  tasks.wait();
+
+  auto includesByCompiler = std::make_shared<std::unordered_map<std::string, std::vector<std::string>>>();
+  for (std::size_t i = 0; i < invocations.size(); i++) {
+    if (results[i]) {
+      spdlog::info("Found {} system include paths for {}.", results[i]->size(), invocations[i].compiler);
+      (*includesByCompiler)[getInvocationKey(invocations[i])] = std::move(*results[i]);
+    }
+  }
+
+  return [includesByCompiler, directories](const clang::tooling::CommandLineArguments& args, llvm::StringRef file) {
+    clang::tooling::CommandLineArguments adjusted  = args;
+    const auto                           directory = directories->find(file.str());
+    const auto                           invocation =
+        hdoc::utils::getCompilerInvocation(args, directory == directories->end() ? "" : directory->second);
+    if (!invocation) {
+      return adjusted;
+    }
+    const auto it = includesByCompiler->find(getInvocationKey(*invocation));
+    if (it == includesByCompiler->end()) {
+      return adjusted;
+    }
+    for (const auto& d : it->second) {
+      adjusted.push_back("-isystem" + d);
+    }
+    return adjusted;
+  };
+}
+
+void hdoc::indexer::Indexer::runMatchers(const std::vector<std::string>& files) {
   hdoc::indexer::matchers::FunctionMatcher  FunctionFinder(&this->index, this->cfg);
   hdoc::indexer::matchers::RecordMatcher    RecordFinder(&this->index, this->cfg);
   hdoc::indexer::matchers::EnumMatcher      EnumFinder(&this->index, this->cfg);
@@ -41,25 +144,171 @@ void hdoc::indexer::Indexer::run() {
   Finder.addMatcher(EnumFinder.getMatcher(), &EnumFinder);
   Finder.addMatcher(NamespaceFinder.getMatcher(), &NamespaceFinder);
 
-  // Add include search paths to clang invocation
-  std::vector<clang::tooling::ArgumentsAdjuster> args = {};
-  for (const std::string& d : cfg->includePaths) {
-    // Ignore include paths that don't exist
-    if (!std::filesystem::exists(d)) {
-      spdlog::warn("Include path {} does not exist. Proceeding without it.", d);
-      continue;
+  // Dependencies are only needed to work out what to re-index when files change
+  hdoc::indexer::DependencyMap* deps = this->cfg->watch ? &this->dependencies : nullptr;
+
+  // Each run is a new build session, so that modules whose headers changed since the last run are validated again
+  std::vector<clang::tooling::ArgumentsAdjuster> args = this->args;
+  args.push_back(
+      hdoc::indexer::getModuleCacheAdjuster(this->cfg->moduleCachePath.string(), this->cfg->prebuiltModulePaths));
+
+  hdoc::indexer::ParallelExecutor tool(*this->cmpdb, args, this->pool, this->cfg->debugLimitNumIndexedFiles, deps);
+  if (files.size() == 0) {
+    tool.execute(clang::tooling::newFrontendActionFactory(&Finder), *this->cmpdb);
+  } else {
+    tool.execute(clang::tooling::newFrontendActionFactory(&Finder), files);
+  }
+}
+
+/// Remove all of the symbols in db that are declared in one of the given files.
+/// The IDs of the removed symbols are appended to removed.
+template <typename T>
+static void removeSymbolsInFiles(hdoc::types::Database<T>&              db,
+                                 const std::unordered_set<std::string>& files,
+                                 std::vector<hdoc::types::SymbolID>&    removed) {
+  for (auto it = db.entries.begin(); it != db.entries.end();) {
+    if (files.find(it->second.file) != files.end()) {
+      removed.push_back(it->first);
+      it = db.entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+hdoc::indexer::IndexDelta hdoc::indexer::Indexer::reindex(const std::vector<std::string>& changedFiles) {
+  IndexDelta delta;
+  if (this->cmpdb == nullptr) {
+    return delta;
+  }
+
+  const std::unordered_set<std::string> changed(changedFiles.begin(), changedFiles.end());
+
+  // Find the translation units that include any of the changed files
+  std::vector<std::string> affectedTUs;
+  for (const auto& [tu, deps] : this->dependencies) {
+    if (std::any_of(deps.begin(), deps.end(), [&](const std::string& d) { return changed.count(d) > 0; })) {
+      affectedTUs.push_back(tu);
+    }
+  }
+  if (affectedTUs.size() == 0) {
+    return delta;
+  }
+
+  // Symbols store their file relative to rootDir, so convert the changed paths to match
+  std::unordered_set<std::string> changedRelPaths;
+  for (const auto& f : changedFiles) {
+    changedRelPaths.insert(std::filesystem::relative(f, this->cfg->rootDir).string());
+  }
+  std::vector<hdoc::types::SymbolID> removed;
+  removeSymbolsInFiles(this->index.functions, changedRelPaths, removed);
+  removeSymbolsInFiles(this->index.records, changedRelPaths, removed);
+  removeSymbolsInFiles(this->index.enums, changedRelPaths, removed);
+
+  // A namespace only records the first file it was found in, but it can be declared in many others, so the
+  // namespaces that are removed are kept aside in case they aren't matched again but other files still use them
+  std::unordered_map<hdoc::types::SymbolID, hdoc::types::NamespaceSymbol> removedNamespaces;
+  for (auto it = this->index.namespaces.entries.begin(); it != this->index.namespaces.entries.end();) {
+    if (changedRelPaths.find(it->second.file) != changedRelPaths.end()) {
+      removedNamespaces.emplace(it->first, std::move(it->second));
+      it = this->index.namespaces.entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Snapshot what remains so that the symbols added by re-indexing can be identified
+  std::unordered_set<hdoc::types::SymbolID> remaining;
+  for (const auto& [k, v] : this->index.functions.entries) {
+    remaining.insert(k);
+  }
+  for (const auto& [k, v] : this->index.records.entries) {
+    remaining.insert(k);
+  }
+  for (const auto& [k, v] : this->index.enums.entries) {
+    remaining.insert(k);
+  }
+  for (const auto& [k, v] : this->index.namespaces.entries) {
+    remaining.insert(k);
+  }
+
+  spdlog::info("Re-indexing {} translation units affected by {} changed files.", affectedTUs.size(), changed.size());
+  this->runMatchers(affectedTUs);
+
+  // Namespaces that weren't matched again are put back if anything is still declared in them, including namespaces
+  // that were only put back themselves, until no more are
+  std::unordered_set<hdoc::types::SymbolID> parents;
+
+  auto collectParents = [&](const auto& db) {
+    for (const auto& [k, v] : db.entries) {
+      parents.insert(v.parentNamespaceID);
+    }
+  };
+  collectParents(this->index.functions);
+  collectParents(this->index.records);
+  collectParents(this->index.enums);
+  collectParents(this->index.namespaces);
+  for (bool restored = true; restored == true;) {
+    restored = false;
+    for (auto it = removedNamespaces.begin(); it != removedNamespaces.end();) {
+      if (this->index.namespaces.contains(it->first)) {
+        it = removedNamespaces.erase(it);
+      } else if (parents.find(it->first) != parents.end()) {
+        parents.insert(it->second.parentNamespaceID);
+        this->index.namespaces.update(it->first, it->second);
+        remaining.insert(it->first);
+        it       = removedNamespaces.erase(it);
+        restored = true;
+      } else {
+        ++it;
+      }
     }
-    spdlog::info("Appending {} to list of include paths.", d);
-    args.push_back(clang::tooling::getInsertArgumentAdjuster(("-isystem" + d).c_str()));
   }
 
-  hdoc::indexer::ParallelExecutor tool(*cmpdb, args, this->pool, this->cfg->debugLimitNumIndexedFiles);
-  tool.execute(clang::tooling::newFrontendActionFactory(&Finder));
+  auto collectUpdated = [&](const auto& db) {
+    for (const auto& [k, v] : db.entries) {
+      if (remaining.find(k) == remaining.end()) {
+        delta.updated.push_back(k);
+      }
+    }
+  };
+  collectUpdated(this->index.functions);
+  collectUpdated(this->index.records);
+  collectUpdated(this->index.enums);
+  collectUpdated(this->index.namespaces);
+  for (const auto& id : removed) {
+    if (!this->index.functions.contains(id) && !this->index.records.contains(id) && !this->index.enums.contains(id)) {
+      delta.removed.push_back(id);
+    }
+  }
+  for (const auto& [id, ns] : removedNamespaces) {
+    delta.removed.push_back(id);
+  }
+  return delta;
+}
+
+std::vector<std::string> hdoc::indexer::Indexer::getDependencies() const {
+  const std::string               rootDir = this->cfg->rootDir.string();
+  std::unordered_set<std::string> unique;
+  for (const auto& [tu, deps] : this->dependencies) {
+    for (const auto& d : deps) {
+      // Files outside of the project are almost never edited, so don't waste watches on them
+      if (d.rfind(rootDir, 0) == 0) {
+        unique.insert(d);
+      }
+    }
+  }
+  return std::vector<std::string>(unique.begin(), unique.end());
 }
 
 void hdoc::indexer::Indexer::resolveNamespaces() {
   spdlog::info("Indexer resolving namespaces.");
   for (auto& [k, ns] : this->index.namespaces.entries) {
+    // Start from scratch so that this can be re-run after re-indexing
+    ns.records.clear();
+    ns.enums.clear();
+    ns.namespaces.clear();
+
     // Add all the direct children of this namespace to its children vector
     for (const auto& [k, v] : this->index.records.entries) {
       if (isChild(ns, v)) {
@@ -83,6 +332,8 @@ void hdoc::indexer::Indexer::resolveNamespaces() {
 void hdoc::indexer::Indexer::updateRecordNames() {
   spdlog::info("Indexer updating record names with inheritance information.");
   for (auto& [k, c] : this->index.records.entries) {
+    // Regenerate the prototype so that inheritance information isn't appended twice after re-indexing
+    c.proto = getRecordProto(c);
     if (c.baseRecords.size() > 0) {
       uint64_t count = 0;
       c.proto += " : ";
@@ -122,21 +373,25 @@ void hdoc::indexer::Indexer::printStats() const {
   const auto enumIndexSize      = this->index.enums.entries.size() * sizeof(hdoc::types::EnumMember) / 1024;
   const auto namespaceIndexSize = this->index.namespaces.entries.size() * sizeof(hdoc::types::NamespaceSymbol) / 1024;
 
-  spdlog::info("Functions:  {} matches, {} indexed, {} KiB total size",
+  spdlog::info("Functions:  {} matches, {} indexed, {} duplicates skipped, {} KiB total size",
                this->index.functions.numMatches,
                this->index.functions.entries.size(),
+               this->index.functions.numDuplicates,
                functionIndexSize);
-  spdlog::info("Records:    {} matches, {} indexed, {} KiB total size",
+  spdlog::info("Records:    {} matches, {} indexed, {} duplicates skipped, {} KiB total size",
                this->index.records.numMatches,
                this->index.records.entries.size(),
+               this->index.records.numDuplicates,
                recordIndexSize);
-  spdlog::info("Enums:      {} matches, {} indexed, {} KiB total size",
+  spdlog::info("Enums:      {} matches, {} indexed, {} duplicates skipped, {} KiB total size",
                this->index.enums.numMatches,
                this->index.enums.entries.size(),
+               this->index.enums.numDuplicates,
                enumIndexSize);
-  spdlog::info("Namespaces: {} matches, {} indexed, {} KiB total size",
+  spdlog::info("Namespaces: {} matches, {} indexed, {} duplicates skipped, {} KiB total size",
                this->index.namespaces.numMatches,
                this->index.namespaces.entries.size(),
+               this->index.namespaces.numDuplicates,
                namespaceIndexSize);
 }
 
@@ -157,25 +412,26 @@ void hdoc::indexer::Indexer::pruneMethods() {
 }
 
 void hdoc::indexer::Indexer::pruneTypeRefs() {
-  for (auto& [k, v] : this->index.functions.entries) {
-    if (this->index.records.contains(v.returnType.id) == false) {
-      v.returnType.id = hdoc::types::SymbolID();
-    }
+  hdoc::utils::pruneTypeRefs(this->index, this->tagFiles);
+}
 
-    for (auto& param : v.params) {
-      if (this->index.records.contains(param.type.id) == false) {
-        param.type.id = hdoc::types::SymbolID();
-      }
-    }
-  }
+std::vector<hdoc::types::SymbolID> hdoc::indexer::Indexer::resolveReverseReferences() {
+  spdlog::info("Indexer resolving reverse references.");
+  auto changed = hdoc::utils::resolveReverseReferences(this->index);
+  spdlog::info("Indexer reverse reference resolution complete.");
+  return changed;
+}
 
-  for (auto& [k, v] : this->index.records.entries) {
-    for (auto& var : v.vars) {
-      if (this->index.records.contains(var.type.id) == false) {
-        var.type.id = hdoc::types::SymbolID();
-      }
-    }
-  }
+void hdoc::indexer::Indexer::computeAncestry() {
+  hdoc::utils::computeAncestry(this->index, this->pool);
+}
+
+void hdoc::indexer::Indexer::computeCollation() {
+  hdoc::utils::computeCollation(this->index, this->pool);
+}
+
+void hdoc::indexer::Indexer::computeFingerprints() {
+  hdoc::utils::computeFingerprints(this->index);
 }
 
 const hdoc::types::Index* hdoc::indexer::Indexer::dump() const {
@@ -3,12 +3,26 @@
 
 #pragma once
 
+#include "clang/Tooling/ArgumentsAdjusters.h"
 #include "llvm/Support/ThreadPool.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "indexer/StreamingCompilationDatabase.hpp"
+#include "serde/TagFile.hpp"
+#include "support/ParallelExecutor.hpp"
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
 namespace hdoc::indexer {
+/// @brief The symbols that were affected by re-indexing a set of changed files.
+struct IndexDelta {
+  std::vector<hdoc::types::SymbolID> updated; ///< Symbols that were added or re-indexed
+  std::vector<hdoc::types::SymbolID> removed; ///< Symbols that no longer exist in the Index
+};
+
 /// @brief Index all of the code in a project into hdoc's internal representation
 class Indexer {
 public:
@@ -16,6 +30,17 @@ public:
   /// @brief Run the indexer over project code
   void run();
 
+  /// @brief Re-index only the translation units affected by the given changed files.
+  /// Symbols declared in the changed files are removed from the Index and the affected translation units
+  /// are parsed again. Namespaces found in the changed files are only removed if they aren't found again and nothing
+  /// else is declared in them. The post-processing passes (pruneMethods, pruneTypeRefs, etc.) must be run again
+  /// afterwards.
+  /// Requires that dependency tracking was enabled (via Config::watch) when run() was called.
+  IndexDelta reindex(const std::vector<std::string>& changedFiles);
+
+  /// @brief Returns the absolute paths of all files under the root directory that the indexed code depends on.
+  std::vector<std::string> getDependencies() const;
+
   /// @brief Update the declaration of the all records to indicate records they inherit
   /// from and the type of inheritance. This must be done after all records are
   /// parsed as the inherited records might not be in the database at parse-time.
@@ -31,8 +56,33 @@ public:
   /// Some TypeRefs might have SymbolIDs that aren't in the Index, for example
   /// if they're in a third-party library that isn't indexed.
   /// We need to remove them prior to HTML serialization to ensure we don't have dead links.
+  /// If one of the imported tag files contains the type, its URL is kept so it can be linked to instead.
+  /// The same is done for every record named inside each type, such as template arguments.
+  /// The IDs are kept aside, so re-running this after re-indexing links types whose records were added back.
+  /// See hdoc::utils::pruneTypeRefs().
   void pruneTypeRefs();
 
+  /// @brief Fill out the "used by" lists of every record from the TypeRefs and base records in the Index.
+  /// This must be run after pruneMethods and pruneTypeRefs so that only symbols in the Index are referenced.
+  /// Returns the IDs of the records whose lists changed since the last time this was run.
+  /// See hdoc::utils::resolveReverseReferences().
+  std::vector<hdoc::types::SymbolID> resolveReverseReferences();
+
+  /// @brief Fill out the lineage of every namespace and record, and the records that every record inherits from.
+  /// This must be run after resolveNamespaces and updateRecordNames, since it reads parents and base records.
+  /// See hdoc::utils::computeAncestry().
+  void computeAncestry();
+
+  /// @brief Sort the symbols of each type by name and give each one its rank, so that lists of symbols can be
+  /// sorted by comparing ranks instead of names. This must be run after all of the passes that add or rename symbols.
+  /// See hdoc::utils::computeCollation().
+  void computeCollation();
+
+  /// @brief Compute the fingerprint of every symbol from its documented content.
+  /// This must be run after all of the other passes, since they change the content of symbols.
+  /// See hdoc::utils::computeFingerprints().
+  void computeFingerprints();
+
   /// @brief Print the number of matches, indexed entries, and size of the database for each type.
   void printStats() const;
 
@@ -40,9 +90,20 @@ public:
   const hdoc::types::Index* dump() const;
 
 private:
-  hdoc::types::Index         index;
-  const hdoc::types::Config* cfg;
-  llvm::ThreadPool&          pool;
+  /// @brief Run the matchers over the given files, or over the whole compilation database if files is empty
+  void runMatchers(const std::vector<std::string>& files = {});
+
+  /// @brief Probe the builtin include paths of every distinct compiler in the compilation database, and return an
+  /// ArgumentsAdjuster that adds the include paths of the compiler named in each compile command
+  clang::tooling::ArgumentsAdjuster getPerTUSystemIncludesAdjuster();
+
+  hdoc::types::Index                                 index;
+  const hdoc::types::Config*                         cfg;
+  llvm::ThreadPool&                                  pool;
+  std::unique_ptr<StreamingCompilationDatabase>      cmpdb;        ///< Kept alive for re-indexing
+  std::vector<clang::tooling::ArgumentsAdjuster>     args;         ///< Extra arguments passed to clang
+  hdoc::indexer::DependencyMap                       dependencies; ///< Files each TU depends on, if tracked
+  std::vector<std::unique_ptr<hdoc::serde::TagFile>> tagFiles;     ///< Tag files of other projects, for linking
 };
 
 } // namespace hdoc::indexer
@@ -12,6 +12,7 @@
 #include "clang/Lex/Lexer.h"
 
 #include "spdlog/spdlog.h"
+#include "llvm/ADT/DenseMap.h"
 
 #include <filesystem>
 
@@ -21,9 +22,9 @@
 /// generated in a non-VFS-aware way can be wrong.
 /// This function is similar to one defined in clang, and gets the canonical path in a
 /// VFS-aware way.
-static llvm::Optional<std::string> getCanonicalPath(const clang::Decl* d) {
-  const auto& sourceManager = d->getASTContext().getSourceManager();
-  const auto* fileEntry     = sourceManager.getFileEntryForID(sourceManager.getFileID(d->getLocation()));
+static llvm::Optional<std::string> getCanonicalPath(const clang::SourceManager& sourceManager,
+                                                    const clang::FileID&        fileID) {
+  const auto* fileEntry = sourceManager.getFileEntryForID(fileID);
 
   if (!fileEntry) {
     return llvm::None;
@@ -47,6 +48,11 @@ static llvm::Optional<std::string> getCanonicalPath(const clang::Decl* d) {
   return path.str().str();
 }
 
+static llvm::Optional<std::string> getCanonicalPath(const clang::Decl* d) {
+  const auto& sourceManager = d->getASTContext().getSourceManager();
+  return getCanonicalPath(sourceManager, sourceManager.getFileID(d->getLocation()));
+}
+
 template <typename T> static bool isParamAndHasName(const T* param) {
   return (param != nullptr) && param->hasParamName();
 }
@@ -106,6 +112,45 @@ bool isInIgnoreList(const clang::Decl*              d,
   return false;
 }
 
+/// Whether each file of the current translation unit is part of the public API, keyed by FileID.
+/// FileIDs are only meaningful within a single translation unit, and each translation unit is matched by a single
+/// thread, so the cache is thread-local and cleared at the start of every translation unit.
+static thread_local llvm::DenseMap<unsigned, bool> publicAPIFileCache;
+
+void resetPublicAPICache() {
+  publicAPIFileCache.clear();
+}
+
+bool isInPublicAPI(const clang::Decl* d, const std::vector<std::filesystem::path>& publicAPIRoots) {
+  const auto&         sourceManager = d->getASTContext().getSourceManager();
+  const clang::FileID fileID =
+      sourceManager.getFileID(sourceManager.getExpansionLoc(d->getCanonicalDecl()->getLocation()));
+
+  // Decls in the main file of a translation unit are implementation details
+  if (fileID.isInvalid() || fileID == sourceManager.getMainFileID()) {
+    return false;
+  }
+
+  auto [it, inserted] = publicAPIFileCache.try_emplace(fileID.getHashValue(), false);
+  if (!inserted) {
+    return it->second;
+  }
+
+  const auto path = getCanonicalPath(sourceManager, fileID);
+  if (!path) {
+    return false;
+  }
+  for (const auto& root : publicAPIRoots) {
+    const std::string r = root.string();
+    if (path->size() > r.size() && path->compare(0, r.size(), r) == 0 &&
+        (*path)[r.size()] == std::filesystem::path::preferred_separator) {
+      it->second = true;
+      break;
+    }
+  }
+  return it->second;
+}
+
 /// Decls in anonymous namespaces should not be documented
 /// This function checks if a declaration is made in an anonymous namespace
 /// or if any of its parents are
@@ -19,6 +19,13 @@ bool isInIgnoreList(const clang::Decl*              d,
                     const std::vector<std::string>& ignorePaths,
                     const std::filesystem::path&    rootDir);
 
+/// @brief Check if a decl is first declared in a header under one of the public API roots.
+/// The result is cached for each file of the current translation unit, so this is cheap to call for every match.
+bool isInPublicAPI(const clang::Decl* d, const std::vector<std::filesystem::path>& publicAPIRoots);
+
+/// @brief Clear the cache used by isInPublicAPI. Must be called at the start of each translation unit.
+void resetPublicAPICache();
+
 /// @brief Check if the decl is in an anonymous namespace
 bool isInAnonymousNamespace(const clang::Decl* d);
 
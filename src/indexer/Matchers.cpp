@@ -5,8 +5,10 @@
 #include "MatcherUtils.hpp"
 #include "types/Symbols.hpp"
 #include "clang/AST/Comment.h"
+#include "clang/AST/DeclTemplate.h"
 #include "clang/Lex/Lexer.h"
 
+#include <cctype>
 #include <string>
 
 /// @brief If the type is a specialized template, convert it to the original non-specialized
@@ -22,56 +24,197 @@ static const clang::ClassTemplateDecl* getNonSpecializedVersionOfDecl(const clan
   return NULL;
 }
 
-/// @brief Try to get a SymbolID from a QualType, and return an empty SymbolID if it's not possible
-static hdoc::types::SymbolID getTypeSymbolID(const clang::QualType& typ) {
-  // Get a TagDecl from the QualType, stripping pointers and references if needed.
+/// @brief Get the record or enum that a type refers to, stripping pointers and references if needed
+static const clang::TagDecl* getTypeTagDecl(const clang::QualType& typ) {
   // Pointers and references look like different types to clang. If we want to
   // have working links in our documentation, types need to have consistent IDs
   // regardless if they are pointers, references, or templates (shown below).
-  const clang::TagDecl* ret = NULL;
   if (const clang::TagDecl* decl = typ->getAsTagDecl()) {
-    ret = decl;
+    return decl;
   } else if (typ->isPointerType() && typ->getPointeeType()->getAsTagDecl()) {
-    ret = typ->getPointeeType()->getAsTagDecl();
+    return typ->getPointeeType()->getAsTagDecl();
   } else if (typ->isReferenceType() && typ.getNonReferenceType()->getAsTagDecl()) {
-    ret = typ.getNonReferenceType()->getAsTagDecl();
+    return typ.getNonReferenceType()->getAsTagDecl();
   } else {
-    ret = NULL;
+    return NULL;
   }
+}
 
+/// @brief Get the SymbolID of a record or enum, and return an empty SymbolID if there's no decl
+static hdoc::types::SymbolID getTagSymbolID(const clang::TagDecl* decl) {
   // Remove the template, if applicble.
   // If the type is a specialized template, convert it to the original non-specialized
   // templated type and use that for the SymbolID.
   // Otherwise clang will consider the specialized type distinct from the non-specialized
   // type and unnecessarily give it a different ID.
-  if (const auto* nonspec = getNonSpecializedVersionOfDecl((clang::TagDecl*)ret)) {
+  if (const auto* nonspec = getNonSpecializedVersionOfDecl(decl)) {
     return buildID(nonspec);
-  } else if (ret == NULL) {
+  } else if (decl == NULL) {
     return hdoc::types::SymbolID();
   } else {
-    return buildID(ret);
+    return buildID(decl);
   }
 }
 
+/// @brief Try to get a SymbolID from a QualType, and return an empty SymbolID if it's not possible
+static hdoc::types::SymbolID getTypeSymbolID(const clang::QualType& typ) {
+  return getTagSymbolID(getTypeTagDecl(typ));
+}
+
+/// The records named in a type, along with the identifier each one is printed as, in the order they're printed
+using NamedTagDecls = std::vector<std::pair<llvm::StringRef, const clang::TagDecl*>>;
+
+static void collectNamedTagDecls(const clang::QualType& typ, NamedTagDecls& decls);
+
+static void collectNamedTagDecls(const llvm::ArrayRef<clang::TemplateArgument> args, NamedTagDecls& decls) {
+  for (const auto& arg : args) {
+    if (arg.getKind() == clang::TemplateArgument::Type) {
+      collectNamedTagDecls(arg.getAsType(), decls);
+    } else if (arg.getKind() == clang::TemplateArgument::Pack) {
+      collectNamedTagDecls(arg.pack_elements(), decls);
+    }
+  }
+}
+
+/// @brief Walk the type as it was written, without desugaring it, and collect every record or enum that it names.
+/// Typedefs are collected with the record they refer to, so that the typedef's name links to the record.
+static void collectNamedTagDecls(const clang::QualType& typ, NamedTagDecls& decls) {
+  if (typ.isNull()) {
+    return;
+  }
+
+  const clang::Type* t = typ.getTypePtr();
+  if (const auto* elaborated = llvm::dyn_cast<clang::ElaboratedType>(t)) {
+    collectNamedTagDecls(elaborated->getNamedType(), decls);
+  } else if (const auto* paren = llvm::dyn_cast<clang::ParenType>(t)) {
+    collectNamedTagDecls(paren->getInnerType(), decls);
+  } else if (const auto* ptr = llvm::dyn_cast<clang::PointerType>(t)) {
+    collectNamedTagDecls(ptr->getPointeeType(), decls);
+  } else if (const auto* ref = llvm::dyn_cast<clang::ReferenceType>(t)) {
+    collectNamedTagDecls(ref->getPointeeTypeAsWritten(), decls);
+  } else if (const auto* memberPtr = llvm::dyn_cast<clang::MemberPointerType>(t)) {
+    // Printed as "int Foo::*", so the pointee comes before the class
+    collectNamedTagDecls(memberPtr->getPointeeType(), decls);
+    collectNamedTagDecls(clang::QualType(memberPtr->getClass(), 0), decls);
+  } else if (const auto* array = llvm::dyn_cast<clang::ArrayType>(t)) {
+    collectNamedTagDecls(array->getElementType(), decls);
+  } else if (const auto* fn = llvm::dyn_cast<clang::FunctionProtoType>(t)) {
+    collectNamedTagDecls(fn->getReturnType(), decls);
+    for (const auto& paramType : fn->param_types()) {
+      collectNamedTagDecls(paramType, decls);
+    }
+  } else if (const auto* subst = llvm::dyn_cast<clang::SubstTemplateTypeParmType>(t)) {
+    collectNamedTagDecls(subst->getReplacementType(), decls);
+  } else if (const auto* typedefType = llvm::dyn_cast<clang::TypedefType>(t)) {
+    if (const auto* decl = getTypeTagDecl(typ)) {
+      decls.emplace_back(typedefType->getDecl()->getName(), decl);
+    }
+  } else if (const auto* spec = llvm::dyn_cast<clang::TemplateSpecializationType>(t)) {
+    if (const auto* templateDecl = spec->getTemplateName().getAsTemplateDecl()) {
+      // Alias templates link to whatever they're an alias of, like typedefs do
+      const clang::TagDecl* decl = getTypeTagDecl(typ);
+      if (const auto* classTemplate = llvm::dyn_cast<clang::ClassTemplateDecl>(templateDecl)) {
+        decl = classTemplate->getTemplatedDecl();
+      }
+      if (decl != NULL) {
+        decls.emplace_back(templateDecl->getName(), decl);
+      }
+    }
+    collectNamedTagDecls(spec->template_arguments(), decls);
+  } else if (const auto* tag = llvm::dyn_cast<clang::TagType>(t)) {
+    decls.emplace_back(tag->getDecl()->getName(), tag->getDecl());
+    // Specializations are printed with their template arguments
+    if (const auto* tagSpec = llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(tag->getDecl())) {
+      collectNamedTagDecls(tagSpec->getTemplateArgs().asArray(), decls);
+    }
+  } else if (const auto* injected = llvm::dyn_cast<clang::InjectedClassNameType>(t)) {
+    decls.emplace_back(injected->getDecl()->getName(), injected->getDecl());
+  }
+}
+
+static bool isIdentifierChar(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/// @brief Find the first occurrence of name in str at or after pos that isn't part of a longer identifier
+static uint64_t findIdentifier(const std::string& str, const llvm::StringRef name, const uint64_t pos) {
+  uint64_t i = str.find(name.data(), pos, name.size());
+  while (i != std::string::npos) {
+    // str[str.size()] is the null terminator, so this is safe when name is at the end of str
+    if ((i == 0 || isIdentifierChar(str[i - 1]) == false) && isIdentifierChar(str[i + name.size()]) == false) {
+      return i;
+    }
+    i = str.find(name.data(), i + 1, name.size());
+  }
+  return i;
+}
+
+/// @brief Build a TypeRef for a type, including the position of every record named in its printed name so that
+/// each of them can be linked to when it's rendered, e.g. both "std::vector" and "MyType" in "std::vector<MyType>"
+static hdoc::types::TypeRef getTypeRef(const clang::QualType& typ, const clang::PrintingPolicy& pp) {
+  hdoc::types::TypeRef ref;
+  ref.name = typ.getAsString(pp);
+  ref.id   = getTypeSymbolID(typ);
+
+  NamedTagDecls decls;
+  collectNamedTagDecls(typ, decls);
+
+  // Names are found in the order they're printed. Ones that can't be found, like default template arguments that
+  // aren't printed, are skipped
+  uint64_t pos = 0;
+  for (const auto& [name, decl] : decls) {
+    if (name.empty()) {
+      continue;
+    }
+    const uint64_t start = findIdentifier(ref.name, name, pos);
+    if (start == std::string::npos) {
+      continue;
+    }
+
+    // Include qualifiers like "std::" in the link, so that the link text is the name that's shown
+    uint64_t qualifiedStart = start;
+    while (qualifiedStart > pos &&
+           (isIdentifierChar(ref.name[qualifiedStart - 1]) || ref.name[qualifiedStart - 1] == ':')) {
+      qualifiedStart--;
+    }
+    ref.tokens.push_back({qualifiedStart, start + name.size() - qualifiedStart, getTagSymbolID(decl)});
+    pos = start + name.size();
+  }
+  return ref;
+}
+
 void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::MatchFinder::MatchResult& Result) {
   const auto res = Result.Nodes.getNodeAs<clang::FunctionDecl>("function");
 
   // Count the number of functions matched
   this->index->functions.numMatches++;
 
-  // Ignore invalid matches, matches in ignored files, and static functions
-  if (res == nullptr || res->isOverloadedOperator() ||
-      isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir) || !res->getSourceRange().isValid() ||
+  // In public API mode, skip symbols that aren't declared in a public header before doing any other work
+  if (res != nullptr && this->cfg->publicAPIOnly && !isInPublicAPI(res, this->cfg->publicAPIRoots)) {
+    return;
+  }
+
+  // Ignore invalid matches and static functions
+  if (res == nullptr || res->isOverloadedOperator() || !res->getSourceRange().isValid() ||
       (res->isStatic() && !res->isCXXClassMember()) || isInAnonymousNamespace(res) ||
       (res->getAccess() == clang::AS_private && cfg->ignorePrivateMembers == true)) {
     return;
   }
 
+  // Most symbols are matched in many translation units, so check if this one was already indexed before doing
+  // anything expensive. Only the translation unit that claims the symbol goes on to extract it.
   const hdoc::types::SymbolID ID = buildID(res);
   if (this->index->functions.contains(ID)) {
+    this->index->functions.numDuplicates++;
+    return;
+  }
+  if (isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir)) {
+    return;
+  }
+  if (this->index->functions.claim(ID) == false) {
+    this->index->functions.numDuplicates++;
     return;
   }
-  this->index->functions.reserve(ID);
   hdoc::types::FunctionSymbol f;
   f.ID = ID;
   fillOutSymbol(f, res, this->cfg->rootDir);
@@ -104,9 +247,8 @@ void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::Ma
   f.params.reserve(res->param_size());
   for (const auto* i : res->parameters()) {
     hdoc::types::FunctionParam a;
-    a.name      = i->getNameAsString();
-    a.type.name = i->getType().getAsString(pp);
-    a.type.id   = getTypeSymbolID(i->getType());
+    a.name = i->getNameAsString();
+    a.type = getTypeRef(i->getType(), pp);
     if (i->hasDefaultArg()) {
       a.defaultValue = i->hasUninstantiatedDefaultArg() ? exprToString(i->getUninstantiatedDefaultArg(), pp)
                                                         : exprToString(i->getDefaultArg(), pp);
@@ -144,8 +286,7 @@ void hdoc::indexer::matchers::FunctionMatcher::run(const clang::ast_matchers::Ma
   // Don't print "void" return type for constructors and destructors.
   f.isCtorOrDtor = clang::isa<clang::CXXConstructorDecl>(res) || clang::isa<clang::CXXDestructorDecl>(res);
   if (f.isCtorOrDtor == false) {
-    f.returnType.name = res->getReturnType().getAsString(pp);
-    f.returnType.id   = getTypeSymbolID(res->getReturnType());
+    f.returnType = getTypeRef(res->getReturnType(), pp);
   }
   f.proto          = getFunctionSignature(f);
   f.isRecordMember = res->isCXXClassMember();
@@ -160,9 +301,14 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
   // Count the number of records matched
   this->index->records.numMatches++;
 
+  // See FunctionMatcher
+  if (res != nullptr && this->cfg->publicAPIOnly && !isInPublicAPI(res, this->cfg->publicAPIRoots)) {
+    return;
+  }
+
   // Ignore invalid matches
   if (res == nullptr || !res->isCompleteDefinition() || !res->getSourceRange().isValid() ||
-      isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir) || isInAnonymousNamespace(res)) {
+      isInAnonymousNamespace(res)) {
     return;
   }
 
@@ -187,11 +333,19 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
     }
   }
 
+  // See FunctionMatcher
   const hdoc::types::SymbolID ID = buildID(res);
   if (this->index->records.contains(ID)) {
+    this->index->records.numDuplicates++;
+    return;
+  }
+  if (isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir)) {
+    return;
+  }
+  if (this->index->records.claim(ID) == false) {
+    this->index->records.numDuplicates++;
     return;
   }
-  this->index->records.reserve(ID);
   hdoc::types::RecordSymbol c;
   c.ID = ID;
   fillOutSymbol(c, res, this->cfg->rootDir);
@@ -309,8 +463,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
     if (field->isAnonymousStructOrUnion() || isAnonRecordMemberVar(field)) {
       mv.type.name = "anonymous struct/union";
     } else {
-      mv.type.name = field->getType().getAsString(pp);
-      mv.type.id   = getTypeSymbolID(field->getType());
+      mv.type = getTypeRef(field->getType(), pp);
     }
 
     const clang::comments::Comment* comment = res->getASTContext().getCommentForDecl(field, nullptr);
@@ -342,8 +495,7 @@ void hdoc::indexer::matchers::RecordMatcher::run(const clang::ast_matchers::Matc
       if (isAnonRecordMemberVar(vd)) {
         mv.type.name = "anonymous struct/union";
       } else {
-        mv.type.name = vd->getType().getAsString(pp);
-        mv.type.id   = getTypeSymbolID(vd->getType());
+        mv.type = getTypeRef(vd->getType(), pp);
       }
 
       const clang::comments::Comment* comment = res->getASTContext().getCommentForDecl(vd, nullptr);
@@ -374,17 +526,29 @@ void hdoc::indexer::matchers::EnumMatcher::run(const clang::ast_matchers::MatchF
   // Count the number of classes matched
   this->index->enums.numMatches++;
 
+  // See FunctionMatcher
+  if (res != nullptr && this->cfg->publicAPIOnly && !isInPublicAPI(res, this->cfg->publicAPIRoots)) {
+    return;
+  }
+
   // Ignore invalid matches and anonymous enums
-  if (res == nullptr || res->getNameAsString() == "" ||
-      isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir) || isInAnonymousNamespace(res)) {
+  if (res == nullptr || res->getNameAsString() == "" || isInAnonymousNamespace(res)) {
     return;
   }
 
+  // See FunctionMatcher
   const hdoc::types::SymbolID ID = buildID(res);
   if (this->index->enums.contains(ID)) {
+    this->index->enums.numDuplicates++;
+    return;
+  }
+  if (isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir)) {
+    return;
+  }
+  if (this->index->enums.claim(ID) == false) {
+    this->index->enums.numDuplicates++;
     return;
   }
-  this->index->enums.reserve(ID);
   hdoc::types::EnumSymbol e;
   e.ID = ID;
   fillOutSymbol(e, res, this->cfg->rootDir);
@@ -437,16 +601,23 @@ void hdoc::indexer::matchers::NamespaceMatcher::run(const clang::ast_matchers::M
   this->index->namespaces.numMatches++;
 
   // Ignore invalid matches and anonymous enums
-  if (res == nullptr || res->getNameAsString() == "" ||
-      isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir) || isInAnonymousNamespace(res)) {
+  if (res == nullptr || res->getNameAsString() == "" || isInAnonymousNamespace(res)) {
     return;
   }
 
+  // See FunctionMatcher
   const hdoc::types::SymbolID ID = buildID(res);
   if (this->index->namespaces.contains(ID)) {
+    this->index->namespaces.numDuplicates++;
+    return;
+  }
+  if (isInIgnoreList(res, this->cfg->ignorePaths, this->cfg->rootDir)) {
+    return;
+  }
+  if (this->index->namespaces.claim(ID) == false) {
+    this->index->namespaces.numDuplicates++;
     return;
   }
-  this->index->namespaces.reserve(ID);
   hdoc::types::NamespaceSymbol n;
   n.ID = ID;
   fillOutSymbol(n, res, this->cfg->rootDir);
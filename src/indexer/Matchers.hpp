@@ -7,6 +7,7 @@
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/ASTMatchers/ASTMatchersMacros.h"
 
+#include "indexer/MatcherUtils.hpp"
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
@@ -41,6 +42,9 @@ AST_MATCHER_P(clang::Decl, shouldBeIgnored, std::vector<std::string>, ignoreList
 class RecordMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
+  void         onStartOfTranslationUnit() override {
+    resetPublicAPICache();
+  }
   RecordMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
   hdoc::types::Index*        index;
   const hdoc::types::Config* cfg;
@@ -64,6 +68,9 @@ public:
 class FunctionMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
+  void         onStartOfTranslationUnit() override {
+    resetPublicAPICache();
+  }
   FunctionMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
   hdoc::types::Index*        index;
   const hdoc::types::Config* cfg;
@@ -86,6 +93,9 @@ public:
 class EnumMatcher : public clang::ast_matchers::MatchFinder::MatchCallback {
 public:
   virtual void run(const clang::ast_matchers::MatchFinder::MatchResult& Result);
+  void         onStartOfTranslationUnit() override {
+    resetPublicAPICache();
+  }
   EnumMatcher(hdoc::types::Index* index, const hdoc::types::Config* cfg) : index(index), cfg(cfg) {}
   hdoc::types::Index*                     index;
   const hdoc::types::Config*              cfg;
@@ -0,0 +1,290 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "indexer/StreamingCompilationDatabase.hpp"
+
+#include "llvm/ADT/Triple.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/StringSaver.h"
+
+namespace {
+constexpr std::size_t npos = llvm::StringRef::npos;
+
+/// Returns the position of the first non-whitespace character at or after pos
+std::size_t skipWhitespace(const llvm::StringRef s, std::size_t pos) {
+  while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\n' || s[pos] == '\r' || s[pos] == '\t')) {
+    pos++;
+  }
+  return pos;
+}
+
+/// Returns the position after the closing quote of the string that starts at pos, or npos if it's unterminated
+std::size_t skipString(const llvm::StringRef s, const std::size_t pos) {
+  for (std::size_t i = pos + 1; i < s.size(); i++) {
+    if (s[i] == '\\') {
+      i++;
+    } else if (s[i] == '"') {
+      return i + 1;
+    }
+  }
+  return npos;
+}
+
+/// Returns the position after the end of the JSON value that starts at pos, or npos if it's malformed
+std::size_t skipValue(const llvm::StringRef s, const std::size_t pos) {
+  if (pos >= s.size()) {
+    return npos;
+  }
+  if (s[pos] == '"') {
+    return skipString(s, pos);
+  }
+  if (s[pos] == '{' || s[pos] == '[') {
+    uint64_t depth = 0;
+    for (std::size_t i = pos; i < s.size(); i++) {
+      if (s[i] == '"') {
+        i = skipString(s, i);
+        if (i == npos) {
+          return npos;
+        }
+        i--;
+      } else if (s[i] == '{' || s[i] == '[') {
+        depth++;
+      } else if (s[i] == '}' || s[i] == ']') {
+        if (--depth == 0) {
+          return i + 1;
+        }
+      }
+    }
+    return npos;
+  }
+  // Numbers, true, false, and null
+  const std::size_t end = s.find_first_of(",}] \t\r\n", pos);
+  return end == npos ? s.size() : end;
+}
+
+/// Unescape a quoted JSON string. Most strings don't contain escapes, so the JSON parser is avoided if possible.
+std::string unquote(const llvm::StringRef quoted) {
+  if (quoted.contains('\\') == false) {
+    return quoted.drop_front().drop_back().str();
+  }
+  auto value = llvm::json::parse(quoted);
+  if (!value) {
+    llvm::consumeError(value.takeError());
+    return "";
+  }
+  return value->getAsString().getValueOr("").str();
+}
+
+/// Returns the absolute, normalized form of path, resolving it against directory if it's relative
+std::string normalizePath(const llvm::StringRef directory, const llvm::StringRef path) {
+  llvm::SmallString<256> absolute(path);
+  if (llvm::sys::path::is_relative(absolute)) {
+    absolute = directory;
+    llvm::sys::path::append(absolute, path);
+  }
+  llvm::sys::path::native(absolute);
+  llvm::sys::path::remove_dots(absolute, true);
+  return absolute.str().str();
+}
+} // namespace
+
+std::unique_ptr<hdoc::indexer::StreamingCompilationDatabase>
+hdoc::indexer::StreamingCompilationDatabase::loadFromFile(const llvm::StringRef path, std::string& err) {
+  // Large files are memory-mapped rather than read, so the file is paged in lazily by the OS
+  auto buffer = llvm::MemoryBuffer::getFile(path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!buffer) {
+    err = "Error while opening JSON database: " + buffer.getError().message();
+    return nullptr;
+  }
+  return std::unique_ptr<StreamingCompilationDatabase>(new StreamingCompilationDatabase(std::move(*buffer)));
+}
+
+bool hdoc::indexer::StreamingCompilationDatabase::scan(std::string&                                     err,
+                                                       const std::function<void(const std::string&)>& onNewFile) {
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (this->scanned) {
+      const std::vector<std::string> known = this->files;
+      lock.unlock();
+      if (onNewFile) {
+        for (const auto& file : known) {
+          onNewFile(file);
+        }
+      }
+      return true;
+    }
+  }
+
+  const llvm::StringRef s   = this->buffer->getBuffer();
+  std::size_t           pos = skipWhitespace(s, 0);
+  if (pos >= s.size() || s[pos] != '[') {
+    err = "Expected a JSON array of compile commands at the start of the compilation database";
+    return false;
+  }
+  pos = skipWhitespace(s, pos + 1);
+
+  while (pos < s.size() && s[pos] != ']') {
+    if (s[pos] != '{') {
+      err = "Expected a compile command object at offset " + std::to_string(pos);
+      return false;
+    }
+
+    // Walk the keys of this object to find the file and directory, skipping over every other value
+    const std::size_t objectStart = pos;
+    std::string       directory;
+    std::string       file;
+    pos = skipWhitespace(s, pos + 1);
+    while (pos < s.size() && s[pos] != '}') {
+      const std::size_t keyEnd = s[pos] == '"' ? skipString(s, pos) : npos;
+      if (keyEnd == npos) {
+        err = "Expected a key in the compile command object at offset " + std::to_string(pos);
+        return false;
+      }
+      const llvm::StringRef key = s.slice(pos + 1, keyEnd - 1);
+
+      pos = skipWhitespace(s, keyEnd);
+      if (pos >= s.size() || s[pos] != ':') {
+        err = "Expected ':' after key at offset " + std::to_string(pos);
+        return false;
+      }
+      const std::size_t valueStart = skipWhitespace(s, pos + 1);
+      const std::size_t valueEnd   = skipValue(s, valueStart);
+      if (valueEnd == npos) {
+        err = "Malformed value in the compile command object at offset " + std::to_string(valueStart);
+        return false;
+      }
+      if (s[valueStart] == '"' && (key == "file" || key == "directory")) {
+        (key == "file" ? file : directory) = unquote(s.slice(valueStart, valueEnd));
+      }
+
+      pos = skipWhitespace(s, valueEnd);
+      if (pos < s.size() && s[pos] == ',') {
+        pos = skipWhitespace(s, pos + 1);
+      }
+    }
+    if (pos >= s.size()) {
+      err = "Unterminated compile command object at offset " + std::to_string(objectStart);
+      return false;
+    }
+    pos++;
+    if (file == "" || directory == "") {
+      err = "Compile command at offset " + std::to_string(objectStart) + " is missing a file or directory";
+      return false;
+    }
+
+    // Record the entry, and tell the caller about the file if it hasn't been seen before
+    const std::string path  = normalizePath(directory, file);
+    bool              isNew = false;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      auto& indices = this->index[path];
+      isNew         = indices.size() == 0;
+      indices.push_back(this->entries.size());
+      this->entries.push_back({objectStart, static_cast<uint32_t>(pos - objectStart)});
+      if (isNew) {
+        this->files.push_back(path);
+      }
+    }
+    if (isNew && onNewFile) {
+      onNewFile(path);
+    }
+
+    pos = skipWhitespace(s, pos);
+    if (pos < s.size() && s[pos] == ',') {
+      pos = skipWhitespace(s, pos + 1);
+    }
+  }
+
+  if (pos >= s.size()) {
+    err = "Unterminated JSON array of compile commands";
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->scanned = true;
+  return true;
+}
+
+clang::tooling::CompileCommand hdoc::indexer::StreamingCompilationDatabase::parseEntry(const Entry& entry) const {
+  clang::tooling::CompileCommand cmd;
+  const llvm::StringRef          json  = this->buffer->getBuffer().substr(entry.offset, entry.length);
+  auto                           value = llvm::json::parse(json);
+  if (!value) {
+    llvm::consumeError(value.takeError());
+    return cmd;
+  }
+  const llvm::json::Object* obj = value->getAsObject();
+  if (obj == nullptr) {
+    return cmd;
+  }
+
+  cmd.Directory = obj->getString("directory").getValueOr("").str();
+  cmd.Filename  = obj->getString("file").getValueOr("").str();
+  cmd.Output    = obj->getString("output").getValueOr("").str();
+  if (const llvm::json::Array* arguments = obj->getArray("arguments")) {
+    for (const auto& arg : *arguments) {
+      cmd.CommandLine.push_back(arg.getAsString().getValueOr("").str());
+    }
+  } else if (const auto command = obj->getString("command")) {
+    // Match the command line syntax that clang's JSONCompilationDatabase auto-detects
+    llvm::BumpPtrAllocator              alloc;
+    llvm::StringSaver                   saver(alloc);
+    llvm::SmallVector<const char*, 64> argv;
+    if (llvm::Triple(llvm::sys::getProcessTriple()).isOSWindows()) {
+      llvm::cl::TokenizeWindowsCommandLine(*command, saver, argv);
+    } else {
+      llvm::cl::TokenizeGNUCommandLine(*command, saver, argv);
+    }
+    cmd.CommandLine.assign(argv.begin(), argv.end());
+  }
+  return cmd;
+}
+
+std::vector<clang::tooling::CompileCommand>
+hdoc::indexer::StreamingCompilationDatabase::getCompileCommands(const llvm::StringRef FilePath) const {
+  llvm::SmallString<256> cwd;
+  llvm::sys::fs::current_path(cwd);
+  const std::string path = normalizePath(cwd, FilePath);
+
+  std::vector<Entry> matches;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    const auto                  it = this->index.find(path);
+    if (it == this->index.end()) {
+      return {};
+    }
+    for (const auto& i : it->second) {
+      matches.push_back(this->entries[i]);
+    }
+  }
+
+  std::vector<clang::tooling::CompileCommand> cmds;
+  for (const auto& entry : matches) {
+    cmds.push_back(this->parseEntry(entry));
+  }
+  return cmds;
+}
+
+std::vector<std::string> hdoc::indexer::StreamingCompilationDatabase::getAllFiles() const {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->files;
+}
+
+std::vector<clang::tooling::CompileCommand> hdoc::indexer::StreamingCompilationDatabase::getAllCompileCommands() const {
+  std::vector<Entry> all;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    all = this->entries;
+  }
+
+  std::vector<clang::tooling::CompileCommand> cmds;
+  cmds.reserve(all.size());
+  for (const auto& entry : all) {
+    cmds.push_back(this->parseEntry(entry));
+  }
+  return cmds;
+}
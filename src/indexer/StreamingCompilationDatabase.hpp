@@ -0,0 +1,61 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hdoc::indexer {
+/// @brief A compilation database for compile_commands.json files that is cheap to load, even for huge files.
+///
+/// clang's JSONCompilationDatabase parses the entire file into a JSON tree and builds every CompileCommand up front,
+/// which takes a long time and a lot of memory for large projects. This implementation memory-maps the file and
+/// scans it once to build an index of each source file's compile command offsets. A command is only parsed when
+/// it's requested with getCompileCommands().
+///
+/// The index is built incrementally by scan(), which reports each new source file as soon as it's found.
+/// This allows files to be processed while the rest of the database is still being scanned.
+/// All methods are thread-safe, but scan() must not be called by several threads at once.
+class StreamingCompilationDatabase : public clang::tooling::CompilationDatabase {
+public:
+  /// @brief Memory-map a compile_commands.json file. It isn't scanned until scan() is called.
+  /// Returns nullptr and sets err if the file can't be read.
+  static std::unique_ptr<StreamingCompilationDatabase> loadFromFile(llvm::StringRef path, std::string& err);
+
+  /// @brief Scan the database, calling onNewFile with the absolute path of each source file the first time it's
+  /// seen. If the database was already scanned, onNewFile is called for each known file instead.
+  /// Returns false and sets err if the database is malformed. Files found before the error remain indexed.
+  bool scan(std::string& err, const std::function<void(const std::string&)>& onNewFile = {});
+
+  std::vector<clang::tooling::CompileCommand> getCompileCommands(llvm::StringRef FilePath) const override;
+  std::vector<std::string>                    getAllFiles() const override;
+  std::vector<clang::tooling::CompileCommand> getAllCompileCommands() const override;
+
+private:
+  explicit StreamingCompilationDatabase(std::unique_ptr<llvm::MemoryBuffer> buffer) : buffer(std::move(buffer)) {}
+
+  /// Location of a single compile command object in the buffer
+  struct Entry {
+    uint64_t offset;
+    uint32_t length;
+  };
+
+  /// Parse the compile command object at entry
+  clang::tooling::CompileCommand parseEntry(const Entry& entry) const;
+
+  std::unique_ptr<llvm::MemoryBuffer>                    buffer;
+  mutable std::mutex                                     mutex;
+  std::vector<Entry>                                     entries; ///< All compile commands, in file order
+  std::vector<std::string>                               files;   ///< Unique source files, in file order
+  std::unordered_map<std::string, std::vector<uint32_t>> index;   ///< Source file -> indices into entries
+  bool                                                   scanned = false; ///< Has the whole file been scanned?
+};
+} // namespace hdoc::indexer
@@ -1,13 +1,183 @@
 // Copyright 2019-2022 hdoc
 // SPDX-License-Identifier: AGPL-3.0-only
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
 
 #include "frontend/Frontend.hpp"
 #include "indexer/Indexer.hpp"
 #include "serde/HTMLWriter.hpp"
+#include "serde/PreviewServer.hpp"
+#include "serde/Serialization.hpp"
+#include "serde/TagFile.hpp"
+#include "support/FileWatcher.hpp"
+#include "support/IndexDiff.hpp"
+
+/// Run all of the indexer's post-processing passes, then export the project's tag file and archive if requested.
+/// This is done after the whole project is indexed, and again every time files are re-indexed in watch mode.
+static void processIndex(hdoc::indexer::Indexer& indexer, const hdoc::types::Config& cfg) {
+  indexer.pruneMethods();
+  indexer.pruneTypeRefs();
+  indexer.resolveNamespaces();
+  indexer.updateRecordNames();
+  indexer.resolveReverseReferences();
+  indexer.computeAncestry();
+  indexer.computeCollation();
+  indexer.computeFingerprints();
+  indexer.printStats();
+
+  if (cfg.tagFileExportPath != "") {
+    hdoc::serde::TagFile::write(*indexer.dump(), cfg.tagFileBaseURL, cfg.tagFileExportPath, cfg.shardPages);
+  }
+  if (cfg.archivePath != "") {
+    std::ofstream out(cfg.archivePath, std::ios::binary);
+    out << hdoc::serde::serialize(*indexer.dump(), cfg);
+    if (!out) {
+      spdlog::error("Unable to write archive to {}.", cfg.archivePath.string());
+    }
+  }
+}
+
+/// Run the indexer and all of its post-processing passes over a project, then export its tag file and archive
+/// if requested
+static void indexProject(hdoc::indexer::Indexer& indexer, const hdoc::types::Config& cfg) {
+  indexer.run();
+  processIndex(indexer, cfg);
+}
+
+/// Print the kind and name of each of the given symbols, one per line, sorted by name
+static void printDiffSymbols(const hdoc::types::Index&                 index,
+                             const std::vector<hdoc::types::SymbolID>& ids,
+                             const char                                marker) {
+  std::vector<std::pair<std::string, std::string>> lines;
+  for (const auto& id : ids) {
+    if (index.functions.contains(id)) {
+      const auto& f = index.functions.entries.at(id);
+      lines.emplace_back(f.proto, f.isRecordMember ? "method" : "function");
+    } else if (index.records.contains(id)) {
+      const auto& c = index.records.entries.at(id);
+      lines.emplace_back(c.name, c.type);
+    } else if (index.enums.contains(id)) {
+      const auto& e = index.enums.entries.at(id);
+      lines.emplace_back(e.name, e.type);
+    } else if (index.namespaces.contains(id)) {
+      lines.emplace_back(index.namespaces.entries.at(id).name, "namespace");
+    }
+  }
+  std::sort(lines.begin(), lines.end());
+  for (const auto& [name, kind] : lines) {
+    fmt::print("{} {} {}\n", marker, kind, name);
+  }
+}
+
+/// Compare the Indexes of two archives and print the symbols that were added, removed, or changed.
+/// Like diff(1), returns 0 if there are no differences, 1 if there are, and 2 if an archive couldn't be read.
+static int runDiff(const std::filesystem::path& oldPath, const std::filesystem::path& newPath) {
+  hdoc::types::Index  oldIndex;
+  hdoc::types::Index  newIndex;
+  hdoc::types::Config oldCfg;
+  hdoc::types::Config newCfg;
+  if (!hdoc::serde::loadArchive(oldPath, oldIndex, oldCfg) || !hdoc::serde::loadArchive(newPath, newIndex, newCfg)) {
+    return 2;
+  }
+
+  const hdoc::utils::IndexDiff diff = hdoc::utils::diffIndexes(oldIndex, newIndex);
+  printDiffSymbols(oldIndex, diff.removed, '-');
+  printDiffSymbols(newIndex, diff.added, '+');
+  printDiffSymbols(newIndex, diff.changed, '~');
+  spdlog::info(
+      "{} symbols added, {} removed, {} changed.", diff.added.size(), diff.removed.size(), diff.changed.size());
+  return diff.size() == 0 ? 0 : 1;
+}
+
+/// Print every page of a project's documentation. Returns false if the output archive is incomplete.
+static bool printDocs(const hdoc::serde::HTMLWriter& htmlWriter) {
+  htmlWriter.printAll();
+  return htmlWriter.finishArchive();
+}
+
+/// Document the project in dir, using the tasks of pool and the bundled assets in assetsDir.
+/// Returns false if its configuration is invalid or its output archive is incomplete.
+static bool documentProject(const hdoc::types::Config&   baseCfg,
+                            const std::filesystem::path& dir,
+                            llvm::ThreadPool&            pool,
+                            const std::string&           assetsDir) {
+  const auto start = std::chrono::steady_clock::now();
+
+  hdoc::types::Config cfg = baseCfg;
+  cfg.rootDir             = dir;
+  hdoc::frontend::Frontend::loadConfigFile(&cfg);
+  if (!cfg.initialized) {
+    spdlog::error("Skipping {} since its configuration is invalid.", dir.string());
+    return false;
+  }
+
+  hdoc::indexer::Indexer indexer(&cfg, pool);
+  indexProject(indexer, cfg);
+  hdoc::serde::HTMLWriter htmlWriter(indexer.dump(), &cfg, pool, assetsDir);
+  const bool              succeeded = printDocs(htmlWriter);
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  spdlog::info("Documented {} in {} ms.", dir.string(), elapsed.count());
+  return succeeded;
+}
+
+/// Generate documentation for several projects in one process.
+/// Two projects are documented at a time, by separate threads that queue their tasks on a single shared thread pool.
+/// Each pass over a project waits for the pool to run out of tasks, so when only one project is documented at a time,
+/// the threads are idle while the last tasks of each pass finish. With two, the tasks of the other project keep them
+/// busy in the meantime. The system include paths, module cache, and bundled assets are shared between all projects.
+static int runBatch(const hdoc::types::Config& baseCfg, const std::vector<std::filesystem::path>& dirs) {
+  const auto       start = std::chrono::steady_clock::now();
+  llvm::ThreadPool pool(llvm::hardware_concurrency(baseCfg.numThreads));
+
+  // Write the bundled assets once, they're linked into each project's output directory
+  llvm::SmallString<64> assetsDir;
+  if (const auto ec = llvm::sys::fs::createUniqueDirectory("hdoc-assets", assetsDir)) {
+    spdlog::error("Unable to create temporary directory for bundled assets: {}.", ec.message());
+    return EXIT_FAILURE;
+  }
+  hdoc::serde::HTMLWriter::writeBundledAssets(assetsDir.str().str());
+
+  // Each thread takes the next project as soon as it's done with its last one.
+  // Every pass waits only for its own tasks through hdoc::utils::TaskGroup, so one project finishing a pass doesn't
+  // wait for the tasks the other project keeps queueing on the same pool.
+  constexpr uint64_t       numProjectThreads = 2;
+  std::atomic<uint64_t>    nextProject       = 0;
+  std::atomic<uint64_t>    numFailed         = 0;
+  std::vector<std::thread> projectThreads;
+  for (uint64_t i = 0; i < std::min<uint64_t>(numProjectThreads, dirs.size()); i++) {
+    projectThreads.emplace_back([&] {
+      for (uint64_t project = nextProject++; project < dirs.size(); project = nextProject++) {
+        if (documentProject(baseCfg, dirs[project], pool, assetsDir.str().str()) == false) {
+          numFailed++;
+        }
+      }
+    });
+  }
+  for (auto& thread : projectThreads) {
+    thread.join();
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(assetsDir.str().str(), ec);
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  spdlog::info("Documented {} of {} projects in {} ms.", dirs.size() - numFailed, dirs.size(), elapsed.count());
+  return numFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
 int main(int argc, char** argv) {
   // Print stack trace on failure
@@ -17,6 +187,13 @@ int main(int argc, char** argv) {
   cfg.binaryType = hdoc::types::BinaryType::Full;
   hdoc::frontend::Frontend frontend(argc, argv, &cfg);
 
+  if (frontend.diffArchives.size() == 2) {
+    return runDiff(frontend.diffArchives[0], frontend.diffArchives[1]);
+  }
+  if (frontend.batchDirs.size() > 0) {
+    return runBatch(cfg, frontend.batchDirs);
+  }
+
   // Ensure that cfg was properly initialized
   if (!cfg.initialized) {
     return EXIT_FAILURE;
@@ -24,20 +201,73 @@ int main(int argc, char** argv) {
 
   llvm::ThreadPool       pool(llvm::hardware_concurrency(cfg.numThreads));
   hdoc::indexer::Indexer indexer(&cfg, pool);
-  indexer.run();
-  indexer.pruneMethods();
-  indexer.pruneTypeRefs();
-  indexer.resolveNamespaces();
-  indexer.updateRecordNames();
-  indexer.printStats();
+  indexProject(indexer, cfg);
   const hdoc::types::Index* index = indexer.dump();
 
   hdoc::serde::HTMLWriter htmlWriter(index, &cfg, pool);
-  htmlWriter.printFunctions();
-  htmlWriter.printRecords();
-  htmlWriter.printNamespaces();
-  htmlWriter.printEnums();
-  htmlWriter.printSearchPage();
-  htmlWriter.processMarkdownFiles();
-  htmlWriter.printProjectIndex();
+  if (cfg.servePort != 0) {
+    spdlog::set_level(spdlog::level::info);
+    hdoc::serde::PreviewServer server(htmlWriter);
+    return server.listen(cfg.servePort) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (printDocs(htmlWriter) == false) {
+    return EXIT_FAILURE;
+  }
+  if (cfg.watch == false) {
+    return EXIT_SUCCESS;
+  }
+
+  // Watch mode: keep the Index in memory and only re-index and re-print what changed
+  hdoc::utils::FileWatcher watcher;
+  for (const auto& dep : indexer.getDependencies()) {
+    watcher.addFile(dep);
+  }
+  std::vector<std::string> mdFiles;
+  for (const auto& md : cfg.mdPaths) {
+    mdFiles.push_back(std::filesystem::absolute(md).lexically_normal().string());
+  }
+  if (cfg.homepage != "") {
+    mdFiles.push_back(std::filesystem::absolute(cfg.homepage).lexically_normal().string());
+  }
+  for (const auto& md : mdFiles) {
+    watcher.addFile(md);
+  }
+  spdlog::set_level(spdlog::level::info);
+  spdlog::info("Watching {} files for changes, press Ctrl+C to exit.", watcher.size());
+
+  while (true) {
+    std::vector<std::string> changed = watcher.waitForChanges();
+    const auto               start   = std::chrono::steady_clock::now();
+
+    // Markdown pages don't affect the Index, so they're handled separately from source files
+    const auto isMarkdown = [&](const std::string& path) {
+      return std::find(mdFiles.begin(), mdFiles.end(), path) != mdFiles.end();
+    };
+    const auto mdBegin =
+        std::stable_partition(changed.begin(), changed.end(), [&](const std::string& p) { return !isMarkdown(p); });
+    if (mdBegin != changed.end()) {
+      htmlWriter.processMarkdownFiles();
+      htmlWriter.printProjectIndex();
+      changed.erase(mdBegin, changed.end());
+    }
+
+    if (changed.size() > 0) {
+      const hdoc::indexer::IndexDelta delta = indexer.reindex(changed);
+      processIndex(indexer, cfg);
+      spdlog::info("Re-indexed {} symbols and removed {}.", delta.updated.size(), delta.removed.size());
+
+      // Unchanged symbols' pages can still link to, or inherit from, the symbols that changed, so every page is
+      // checked against its inputs rather than only printing those of the changed symbols
+      htmlWriter.printAll();
+
+      // Edits may have pulled in new headers
+      for (const auto& dep : indexer.getDependencies()) {
+        watcher.addFile(dep);
+      }
+    }
+
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    spdlog::info("Rebuilt documentation in {} ms.", elapsed.count());
+  }
 }
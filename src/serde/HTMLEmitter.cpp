@@ -0,0 +1,168 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/HTMLEmitter.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+/// Returns true if any of the eight characters packed into word needs to be escaped.
+/// Each comparison uses the "has a zero byte" trick from Bit Twiddling Hacks on word XOR the character repeated.
+/// '&' and '\'' only differ in their lowest bit, as do '<' and '>' in their second lowest bit, so setting that bit
+/// in every byte lets one comparison catch both characters of each pair.
+static bool needsEscaping(const uint64_t word) {
+  constexpr uint64_t ones  = 0x0101010101010101ULL;
+  constexpr uint64_t highs = 0x8080808080808080ULL;
+
+  const uint64_t ampOrApos = (word | ones) ^ (ones * '\'');
+  const uint64_t ltOrGt    = (word | (ones * 0x02)) ^ (ones * '>');
+  const uint64_t quot      = word ^ (ones * '"');
+  const auto     hasZero   = [](const uint64_t x) { return (x - ones) & ~x & highs; };
+  return (hasZero(ampOrApos) | hasZero(ltOrGt) | hasZero(quot)) != 0;
+}
+
+void hdoc::serde::appendEscapedHTML(std::string& out, const std::string_view s) {
+  // Copy runs of characters that don't need escaping in one go
+  uint64_t runStart = 0;
+  for (uint64_t i = 0; i < s.size();) {
+    // Skip eight characters at a time until reaching a block that contains something to escape
+    if (s.size() - i >= 8) {
+      uint64_t word;
+      std::memcpy(&word, s.data() + i, sizeof(word));
+      if (needsEscaping(word) == false) {
+        i += 8;
+        continue;
+      }
+    }
+
+    const uint64_t blockEnd = std::min(i + 8, static_cast<uint64_t>(s.size()));
+    for (; i < blockEnd; i++) {
+      std::string_view replacement;
+      switch (s[i]) {
+      case '&':
+        replacement = "&amp;";
+        break;
+      case '<':
+        replacement = "&lt;";
+        break;
+      case '>':
+        replacement = "&gt;";
+        break;
+      case '"':
+        replacement = "&quot;";
+        break;
+      case '\'':
+        replacement = "&apos;";
+        break;
+      default:
+        continue;
+      }
+      out.append(s.data() + runStart, i - runStart);
+      out.append(replacement);
+      runStart = i + 1;
+    }
+  }
+  out.append(s.data() + runStart, s.size() - runStart);
+}
+
+void hdoc::serde::appendLinkedHTML(std::string& out, const std::string_view s, const std::vector<HTMLLink>& links) {
+  // Reserve enough for the links and a few escaped characters up front so that out is only grown once
+  uint64_t size = out.size() + s.size() + s.size() / 4;
+  for (const auto& link : links) {
+    size += link.href.size() + sizeof("<a href=\"\"></a>");
+  }
+  out.reserve(size);
+
+  uint64_t pos = 0;
+  for (const auto& link : links) {
+    appendEscapedHTML(out, s.substr(pos, link.start - pos));
+    out += "<a href=\"";
+    out += link.href;
+    out += "\">";
+    appendEscapedHTML(out, s.substr(link.start, link.length));
+    out += "</a>";
+    pos = link.start + link.length;
+  }
+  appendEscapedHTML(out, s.substr(pos));
+}
+
+hdoc::serde::HTMLEmitter& hdoc::serde::HTMLEmitter::open(const std::string_view selector) {
+  this->finishStartTag();
+
+  // Split the selector into the tag name and the ".class" and "#id" parts that follow it
+  const uint64_t         nameEnd = std::min(selector.find('.'), selector.find('#'));
+  const std::string_view name    = selector.substr(0, nameEnd);
+  const std::string_view rest    = nameEnd == std::string_view::npos ? "" : selector.substr(nameEnd);
+
+  this->buffer += '<';
+  this->tags.emplace_back(this->buffer.size(), name.size());
+  this->buffer += name;
+
+  // CTML prints all classes before the id, regardless of the order they're given in
+  std::string_view id         = "";
+  bool             hasClasses = false;
+  for (uint64_t i = 0; i < rest.size();) {
+    const uint64_t         end   = std::min(rest.find_first_of(".#", i + 1), rest.size());
+    const std::string_view value = rest.substr(i + 1, end - i - 1);
+    if (rest[i] == '#') {
+      id = value;
+    } else {
+      this->buffer += hasClasses ? " " : " class=\"";
+      this->buffer += value;
+      hasClasses = true;
+    }
+    i = end;
+  }
+  if (hasClasses) {
+    this->buffer += '"';
+  }
+  if (id != "") {
+    this->buffer += " id=\"";
+    this->buffer += id;
+    this->buffer += '"';
+  }
+
+  this->inStartTag = true;
+  return *this;
+}
+
+hdoc::serde::HTMLEmitter& hdoc::serde::HTMLEmitter::attr(const std::string_view name, const std::string_view value) {
+  // Once the start tag is terminated, the attribute would end up in the element's content
+  assert(this->inStartTag && "attr() must be called right after open()");
+  this->buffer += ' ';
+  this->buffer += name;
+  this->buffer += "=\"";
+  appendEscapedHTML(this->buffer, value);
+  this->buffer += '"';
+  return *this;
+}
+
+hdoc::serde::HTMLEmitter& hdoc::serde::HTMLEmitter::text(const std::string_view s) {
+  this->finishStartTag();
+  appendEscapedHTML(this->buffer, s);
+  return *this;
+}
+
+hdoc::serde::HTMLEmitter& hdoc::serde::HTMLEmitter::raw(const std::string_view s) {
+  this->finishStartTag();
+  this->buffer += s;
+  return *this;
+}
+
+hdoc::serde::HTMLEmitter& hdoc::serde::HTMLEmitter::close() {
+  this->finishStartTag();
+  const auto [offset, length] = this->tags.back();
+  this->tags.pop_back();
+  this->buffer += "</";
+  // Copy the name out first since appending part of a string to itself may reallocate it midway
+  char name[32];
+  if (length <= sizeof(name)) {
+    this->buffer.copy(name, length, offset);
+    this->buffer.append(name, length);
+  } else {
+    this->buffer += this->buffer.substr(offset, length);
+  }
+  this->buffer += '>';
+  return *this;
+}
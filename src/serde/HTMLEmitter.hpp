@@ -0,0 +1,81 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hdoc::serde {
+/// @brief Append s to out, escaping the characters that are special in HTML text and attribute values
+void appendEscapedHTML(std::string& out, const std::string_view s);
+
+/// @brief A hyperlink over the characters [start, start + length) of the text given to appendLinkedHTML()
+struct HTMLLink {
+  uint64_t    start  = 0;
+  uint64_t    length = 0;
+  std::string href;
+};
+
+/// @brief Append s to out escaped, like appendEscapedHTML(), with the span of each link wrapped in an <a> element.
+/// Links must be sorted by start and must not overlap. The hrefs are written as-is.
+void appendLinkedHTML(std::string& out, const std::string_view s, const std::vector<HTMLLink>& links);
+
+/// @brief Writes HTML directly into a string, without building a tree of nodes first.
+///
+/// Start tags are written like CTML writes them: the tag name, then the classes, then the id, then the remaining
+/// attributes in the order they were added. CTML keeps the remaining attributes in an unordered_map, so the output
+/// is only the same as CTML's for elements with at most one attribute besides the classes and id. Text and attribute
+/// values are escaped. Start tags are left unterminated until the first child, text, or closing tag is written so
+/// that attributes can be added after open().
+///
+/// Elements are named with the same Emmet-like selectors as CTML, e.g. "a.is-family-code" or "div#wrapper".
+class HTMLEmitter {
+public:
+  /// @brief Append to buffer. The buffer is not cleared, so it can be reused between pages to avoid reallocation.
+  explicit HTMLEmitter(std::string& buffer) : buffer(buffer) {}
+
+  /// @brief Start a new element, which is a child of the element that's currently open
+  HTMLEmitter& open(const std::string_view selector);
+
+  /// @brief Add an attribute to the element that was just opened, before anything is written inside it.
+  /// The value is escaped.
+  HTMLEmitter& attr(const std::string_view name, const std::string_view value);
+
+  /// @brief Append escaped text to the element that's currently open
+  HTMLEmitter& text(const std::string_view s);
+
+  /// @brief Append HTML to the element that's currently open without escaping it
+  HTMLEmitter& raw(const std::string_view s);
+
+  /// @brief Close the element that's currently open
+  HTMLEmitter& close();
+
+  /// @brief Shorthand for an element that only contains text, i.e. open(selector).text(s).close()
+  HTMLEmitter& element(const std::string_view selector, const std::string_view s) {
+    return this->open(selector).text(s).close();
+  }
+
+  /// @brief Returns the number of elements that are open
+  uint64_t depth() const {
+    return this->tags.size();
+  }
+
+private:
+  /// Terminate the start tag of the element that was just opened, if it hasn't been already
+  void finishStartTag() {
+    if (this->inStartTag) {
+      this->buffer += '>';
+      this->inStartTag = false;
+    }
+  }
+
+  std::string& buffer;
+  /// Offset and length of each open element's name in buffer, which is where it's copied from when it's closed
+  std::vector<std::pair<uint64_t, uint64_t>> tags;
+  bool                                       inStartTag = false;
+};
+} // namespace hdoc::serde
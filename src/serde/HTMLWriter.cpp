@@ -6,16 +6,28 @@
 #include "clang/Basic/Specifiers.h"
 #include "clang/Format/Format.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/xxhash.h"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
-#include <stack>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
 #include "serde/CppReferenceURLs.hpp"
+#include "serde/HTMLEmitter.hpp"
 #include "serde/HTMLWriter.hpp"
+#include "serde/PrototypeFormatter.hpp"
 #include "support/MarkdownConverter.hpp"
 #include "support/StringUtils.hpp"
+#include "support/TaskGroup.hpp"
 #include "types/Symbols.hpp"
 
 /// Implementation of to_string() for Clang member variable access specifier
@@ -34,32 +46,23 @@ static std::string to_string(const clang::AccessSpecifier& access) {
   }
 }
 
-/// Returns a vector of all SymbolIDs in a given database
-/// Useful for getting a vector of SymbolIDs that will be sorted
-template <typename T> static std::vector<hdoc::types::SymbolID> map2vec(const hdoc::types::Database<T>& db) {
-  std::vector<hdoc::types::SymbolID> IDs;
-  IDs.reserve(db.entries.size());
-  for (const auto& [k, v] : db.entries) {
-    IDs.push_back(k);
-  }
-  return IDs;
-}
-
-/// Sort a vector of SymbolIDs alphabetically by the name of the Symbol they point to
+/// Sort a vector of SymbolIDs alphabetically by the name of the Symbol they point to, using the ranks computed by
+/// Indexer::computeCollation().
 /// Note: all members of IDs need to be of type T
 template <typename T>
 static std::vector<hdoc::types::SymbolID> getSortedIDs(const std::vector<hdoc::types::SymbolID>& IDs,
                                                        const hdoc::types::Database<T>&           db) {
-  std::vector<T> symbols = {};
-  symbols.reserve(IDs.size());
+  std::vector<std::pair<uint32_t, hdoc::types::SymbolID>> ranked;
+  ranked.reserve(IDs.size());
   for (const auto& id : IDs) {
-    symbols.push_back(db.entries.at(id));
+    ranked.emplace_back(db.ranks.at(id), id);
   }
-  std::sort(symbols.begin(), symbols.end());
+  std::sort(ranked.begin(), ranked.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
   std::vector<hdoc::types::SymbolID> sortedIDs;
   sortedIDs.reserve(IDs.size());
-  for (const auto& s : symbols) {
-    sortedIDs.push_back(s.ID);
+  for (const auto& [rank, id] : ranked) {
+    sortedIDs.push_back(id);
   }
   return sortedIDs;
 }
@@ -89,10 +92,58 @@ extern unsigned int ___assets_auto_render_min_js_len;
 extern unsigned int ___assets_highlight_min_js_len;
 extern unsigned int ___assets_index_min_js_len;
 
-hdoc::serde::HTMLWriter::HTMLWriter(const hdoc::types::Index*  index,
-                                    const hdoc::types::Config* cfg,
-                                    llvm::ThreadPool&          pool)
-    : index(index), cfg(cfg), pool(pool) {
+/// An asset bundled with hdoc, and where it goes in the output directory
+struct BundledFile {
+  const unsigned int          len;
+  const uint8_t*              file;
+  const std::filesystem::path path;
+};
+
+/// Returns the assets bundled with hdoc, with their paths in dir
+static std::vector<BundledFile> getBundledAssets(const std::filesystem::path& dir) {
+  // hdoc bundles assets (favicons, CSS) with the executable to simplify deployment.
+  // The following code collects the files (converted to char arrays in the build process)
+  // and outputs them. The process looks janky but it's simple and it works.
+  return {
+      {___assets_apple_touch_icon_png_len, ___assets_apple_touch_icon_png, dir / "apple-touch-icon.png"},
+      {___assets_favicon_16x16_png_len, ___assets_favicon_16x16_png, dir / "favicon-16x16.png"},
+      {___assets_favicon_32x32_png_len, ___assets_favicon_32x32_png, dir / "favicon-32x32.png"},
+      {___assets_favicon_ico_len, ___assets_favicon_ico, dir / "favicon.ico"},
+      {___assets_styles_css_len, ___assets_styles_css, dir / "styles.css"},
+      {___assets_search_js_len, ___assets_search_js, dir / "search.js"},
+      {___assets_worker_js_len, ___assets_worker_js, dir / "worker.js"},
+      {___assets_katex_min_css_len, ___assets_katex_min_css, dir / "katex.min.css"},
+      {___assets_katex_min_js_len, ___assets_katex_min_js, dir / "katex.min.js"},
+      {___assets_auto_render_min_js_len, ___assets_auto_render_min_js, dir / "auto-render.min.js"},
+      {___assets_highlight_min_js_len, ___assets_highlight_min_js, dir / "highlight.min.js"},
+      {___assets_index_min_js_len, ___assets_index_min_js, dir / "index.min.js"},
+  };
+}
+
+static hdoc::serde::PageShell getPageShell(const hdoc::types::Config& cfg);
+static uint64_t               getRenderKey(const hdoc::types::Config& cfg, const hdoc::serde::PageShell& shell);
+
+hdoc::serde::HTMLWriter::HTMLWriter(const hdoc::types::Index*    index,
+                                    const hdoc::types::Config*   cfg,
+                                    llvm::ThreadPool&            pool,
+                                    const std::filesystem::path& sharedAssetsDir)
+    : index(index), cfg(cfg), pool(pool), shell(getPageShell(*cfg)), renderKey(getRenderKey(*cfg, shell)) {
+  // The preview server renders pages when they're requested and serves assets from memory, so nothing is written
+  if (this->cfg->servePort != 0) {
+    this->output.keepInMemory();
+    return;
+  }
+
+  // Pages streamed into an archive never touch the output directory, so it isn't created and there's no manifest.
+  // The archive has its own copy of the assets, even in batch mode.
+  if (this->cfg->outputArchive != "") {
+    if (this->output.useArchive(this->cfg->outputArchive, this->cfg->outputDir) == false) {
+      std::exit(1);
+    }
+    this->writesAssets = true;
+    return;
+  }
+
   // Create the directory where the HTML files will be placed
   std::error_code ec;
   if (std::filesystem::exists(this->cfg->outputDir) == false) {
@@ -104,51 +155,89 @@ hdoc::serde::HTMLWriter::HTMLWriter(const hdoc::types::Index*  index,
     }
   }
 
-  // hdoc bundles assets (favicons, CSS) with the executable to simplify deployment.
-  // The following code collects the files (converted to char arrays in the build process)
-  // and outputs them. The process looks janky but it's simple and it works.
-  struct BundledFile {
-    const unsigned int          len;
-    const uint8_t*              file;
-    const std::filesystem::path path;
-  };
+  // Create every shard's subdirectory up front, so that writing pages never has to check whether it exists
+  if (this->cfg->shardPages) {
+    for (uint32_t i = 0; i < 256; i++) {
+      const std::filesystem::path dir = this->cfg->outputDir / fmt::format("{:02X}", i);
+      if (std::filesystem::create_directory(dir, ec); ec) {
+        spdlog::error("Creation of directory {} failed with the following error message: '{}'. Exiting.",
+                      dir.string(),
+                      ec.message());
+        std::exit(1);
+      }
+    }
+  }
 
-  std::vector<BundledFile> bundledFiles = {
-      {___assets_apple_touch_icon_png_len, ___assets_apple_touch_icon_png, cfg->outputDir / "apple-touch-icon.png"},
-      {___assets_favicon_16x16_png_len, ___assets_favicon_16x16_png, cfg->outputDir / "favicon-16x16.png"},
-      {___assets_favicon_32x32_png_len, ___assets_favicon_32x32_png, cfg->outputDir / "favicon-32x32.png"},
-      {___assets_favicon_ico_len, ___assets_favicon_ico, cfg->outputDir / "favicon.ico"},
-      {___assets_styles_css_len, ___assets_styles_css, cfg->outputDir / "styles.css"},
-      {___assets_search_js_len, ___assets_search_js, cfg->outputDir / "search.js"},
-      {___assets_worker_js_len, ___assets_worker_js, cfg->outputDir / "worker.js"},
-      {___assets_katex_min_css_len, ___assets_katex_min_css, cfg->outputDir / "katex.min.css"},
-      {___assets_katex_min_js_len, ___assets_katex_min_js, cfg->outputDir / "katex.min.js"},
-      {___assets_auto_render_min_js_len, ___assets_auto_render_min_js, cfg->outputDir / "auto-render.min.js"},
-      {___assets_highlight_min_js_len, ___assets_highlight_min_js, cfg->outputDir / "highlight.min.js"},
-      {___assets_index_min_js_len, ___assets_index_min_js, cfg->outputDir / "index.min.js"},
-  };
+  // Files that are the same as in the previous run aren't written again, and those that are no longer part of the
+  // documentation are deleted once all of the pages have been printed
+  this->output.useManifest(this->cfg->outputDir);
+
+  // Hard link the assets that were already written, falling back to copying them if that isn't possible
+  // (e.g. if the output directory is on a different filesystem).
+  // They're removed through the OutputWriter so that the manifest doesn't claim they were written by this project.
+  if (sharedAssetsDir.empty() == false) {
+    std::filesystem::directory_iterator it(sharedAssetsDir, ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+      const std::filesystem::path dest = this->cfg->outputDir / it->path().filename();
+      std::error_code             linkError;
+      this->output.remove(dest);
+      std::filesystem::create_hard_link(it->path(), dest, linkError);
+      if (linkError) {
+        std::filesystem::copy_file(it->path(), dest, std::filesystem::copy_options::overwrite_existing, linkError);
+      }
+    }
+    if (!ec) {
+      return;
+    }
+    spdlog::warn("Unable to read the shared assets in {} ({}). Writing them to {} instead.",
+                 sharedAssetsDir.string(),
+                 ec.message(),
+                 this->cfg->outputDir.string());
+  }
+  this->writesAssets = true;
+}
 
-  for (const auto& file : bundledFiles) {
+void hdoc::serde::HTMLWriter::writeBundledAssets(const std::filesystem::path& dir) {
+  for (const auto& file : getBundledAssets(dir)) {
     std::ofstream out(file.path, std::ios::binary);
     out.write((char*)file.file, file.len);
     out.close();
   }
 }
 
-/// Create a new HTML page with standard structure
-/// Optional sidebar, CSS styling, favicons, footer, etc.
-static void printNewPage(const hdoc::types::Config&   cfg,
-                         CTML::Node                   main,
-                         const std::filesystem::path& path,
-                         const std::string_view       pageTitle,
-                         CTML::Node                   breadcrumbs = CTML::Node()) {
+std::optional<std::string_view> hdoc::serde::HTMLWriter::getBundledAsset(const std::string_view name) {
+  for (const auto& file : getBundledAssets("")) {
+    if (file.path == name) {
+      return std::string_view(reinterpret_cast<const char*>(file.file), file.len);
+    }
+  }
+  return std::nullopt;
+}
+
+/// Markers that are replaced by the title and content of each page when the page shell is split into its parts
+static constexpr char pageTitleMarker[]   = "\x01hdoc-page-title\x01";
+static constexpr char pageContentMarker[] = "\x01hdoc-page-content\x01";
+
+/// Returns the URL of the page that the Markdown file at path is converted to
+static std::string getMarkdownPageURL(const std::filesystem::path& path) {
+  return "doc" + path.filename().replace_extension("html").string();
+}
+
+/// Returns the title of the page that the Markdown file at path is converted to, which is also its sidebar entry
+static std::string getMarkdownPageTitle(const std::filesystem::path& path) {
+  return path.filename().stem().string();
+}
+
+/// Create the standard structure shared by all HTML pages: sidebar, CSS styling, favicons, footer, etc.
+/// It's rendered once, and then split at the markers so that only the title and content are rendered per page.
+static hdoc::serde::PageShell getPageShell(const hdoc::types::Config& cfg) {
   CTML::Document html;
 
   // Create the header, which includes Bulma CSS framework
   html.AppendNodeToHead(CTML::Node("meta").SetAttr("charset", "utf-8"));
   html.AppendNodeToHead(
       CTML::Node("meta").SetAttr("name", "viewport").SetAttr("content", "width=device-width, initial-scale=1"));
-  html.AppendNodeToHead(CTML::Node("title", std::string(pageTitle)));
+  html.head().AppendRawHTML(pageTitleMarker);
 
   // Use our custom css which is a modified version of bulma
   html.AppendNodeToHead(CTML::Node("link").SetAttr("rel", "stylesheet").SetAttr("href", "styles.css"));
@@ -212,8 +301,8 @@ static void printNewPage(const hdoc::types::Config&   cfg,
   if (cfg.mdPaths.size() > 0) {
     menuUL.AddChild(CTML::Node("p.menu-label", "Pages"));
     for (const auto& f : cfg.mdPaths) {
-      std::string path = "doc" + f.filename().replace_extension("html").string();
-      std::string name = f.filename().stem().string();
+      std::string path = getMarkdownPageURL(f);
+      std::string name = getMarkdownPageTitle(f);
       menuUL.AddChild(CTML::Node("li").AddChild(CTML::Node("a", name).SetAttr("href", path)));
     }
   }
@@ -227,23 +316,54 @@ static void printNewPage(const hdoc::types::Config&   cfg,
   aside.AddChild(menuUL);
 
   columnsDiv.AddChild(aside);
-  columnsDiv.AddChild(mainColumn.AddChild(breadcrumbs).AddChild(main.SetAttr("class", "content")));
+  columnsDiv.AddChild(mainColumn.AppendRawHTML(pageContentMarker));
   containerDiv.AddChild(columnsDiv);
   section.AddChild(containerDiv);
   wrapperDiv.AddChild(section);
   html.AppendNodeToBody(wrapperDiv);
 
-  // Create footer with creation date and details
+  // Create footer with creation date, if there is one, and details
+  const std::string onDate = cfg.timestamp == "" ? "" : " on " + cfg.timestamp;
+
   CTML::Node p1 = CTML::Node(
       "p", "Documentation for " + cfg.projectName + (cfg.projectVersion == "" ? "." : " " + cfg.projectVersion + "."));
   CTML::Node p2 = CTML::Node("p", "Generated by ")
                       .AddChild(CTML::Node("a", "hdoc").SetAttr("href", "https://hdoc.io/"))
-                      .AppendText(" version " + cfg.hdocVersion + " on " + cfg.timestamp + ".");
+                      .AppendText(" version " + cfg.hdocVersion + onDate + ".");
   CTML::Node p3 = CTML::Node("p.has-text-grey-light", "19AD43E11B2996");
   html.AppendNodeToBody(CTML::Node("footer.footer").AddChild(p1).AddChild(p2).AddChild(p3));
 
-  // Dump to a file
-  std::ofstream(path) << html.ToString();
+  // Split the page at the markers
+  const std::string      page       = html.ToString();
+  const std::size_t      titlePos   = page.find(pageTitleMarker);
+  const std::size_t      contentPos = page.find(pageContentMarker);
+  const std::size_t      titleLen   = sizeof(pageTitleMarker) - 1;
+  const std::size_t      contentLen = sizeof(pageContentMarker) - 1;
+  hdoc::serde::PageShell shell;
+  shell.prefix = page.substr(0, titlePos);
+  shell.middle = page.substr(titlePos + titleLen, contentPos - titlePos - titleLen);
+  shell.suffix = page.substr(contentPos + contentLen);
+  return shell;
+}
+
+/// Print a page with the given title, breadcrumbs, and main content inside the page shell
+static void printNewPage(hdoc::serde::OutputWriter&    output,
+                         const hdoc::serde::PageShell& shell,
+                         CTML::Node                    main,
+                         const std::filesystem::path&  path,
+                         const std::string_view        pageTitle,
+                         CTML::Node                    breadcrumbs = CTML::Node()) {
+  std::string out = output.acquireBuffer();
+  out += shell.prefix;
+  out += CTML::Node("title", std::string(pageTitle)).ToString();
+  out += shell.middle;
+  // Pages without breadcrumbs pass an empty node, which CTML would skip when adding it as a child
+  if (breadcrumbs.Name() != "") {
+    out += breadcrumbs.ToString();
+  }
+  out += main.SetAttr("class", "content").ToString();
+  out += shell.suffix;
+  output.write(path, std::move(out));
 }
 
 /// Return a short string describing a symbol for its entry in the overview list
@@ -311,315 +431,385 @@ std::string hdoc::serde::getBareTypeName(const std::string_view typeName) {
   return str;
 }
 
+/// Returns the page documenting a type: its own page if it's indexed, or the page in another project's
+/// documentation if it came from a tag file. Returns an empty string if neither is available.
+static std::string getTypeURL(const hdoc::types::TypeRef& type, const bool sharded) {
+  if (type.id.raw() != 0) {
+    return hdoc::types::pageURL('r', type.id, sharded);
+  }
+  return type.externalURL;
+}
+
+/// Returns the cppreference page for a bare std:: type name, or an empty string if it isn't in the map above.
+static std::string getStdTypeURL(const std::string& bareTypeName) {
+  if (bareTypeName.starts_with("std::") == false) {
+    return "";
+  }
+  const auto it = StdTypeURLMap.find(bareTypeName);
+  return it == StdTypeURLMap.end() ? "" : std::string(cppreferenceURL) + it->second;
+}
+
+/// Returns the page for one of the names in a type, in the same order of preference as getTypeURL(), falling back to
+/// cppreference for std:: types. Returns an empty string if there's nothing to link to.
+static std::string
+getTokenURL(const hdoc::types::TypeRef::Token& token, const std::string& text, const bool sharded) {
+  if (token.id.raw() != 0) {
+    return hdoc::types::pageURL('r', token.id, sharded);
+  }
+  if (token.externalURL != "") {
+    return token.externalURL;
+  }
+  return getStdTypeURL(text);
+}
+
+/// Map the spans of a type's tokens onto the formatted type name.
+/// Formatting only changes whitespace, and tokens don't contain any, so the two strings are walked in step while
+/// skipping whitespace in both.
+static std::vector<hdoc::serde::HTMLLink>
+getTokenLinks(const hdoc::types::TypeRef& type, const std::string_view formatted, const bool sharded) {
+  const auto isSpace = [](const char c) { return c == ' ' || c == '\n'; };
+
+  std::vector<hdoc::serde::HTMLLink> links;
+  uint64_t                           i = 0;
+  uint64_t                           j = 0;
+  for (const auto& token : type.tokens) {
+    while (i < token.start) {
+      if (isSpace(type.name[i]) == false) {
+        while (j < formatted.size() && isSpace(formatted[j])) {
+          j++;
+        }
+        j++;
+      }
+      i++;
+    }
+    while (j < formatted.size() && isSpace(formatted[j])) {
+      j++;
+    }
+
+    const std::string text = type.name.substr(token.start, token.length);
+    if (formatted.substr(j, token.length) != text) {
+      break;
+    }
+    if (std::string url = getTokenURL(token, text, sharded); url != "") {
+      links.push_back({j, token.length, std::move(url)});
+    }
+  }
+  return links;
+}
+
+/// Link the first occurrence of bareTypeName in s at or after pos, and move pos past it.
+static void addTypeLink(std::vector<hdoc::serde::HTMLLink>& links,
+                        const std::string_view              s,
+                        const std::string&                  bareTypeName,
+                        std::string                         url,
+                        uint64_t&                           pos) {
+  const uint64_t start = s.find(bareTypeName, pos);
+  if (start == std::string_view::npos) {
+    return;
+  }
+  links.push_back({start, bareTypeName.size(), std::move(url)});
+  pos = start + bareTypeName.size();
+}
+
 /// Replaces type names in a function proto with hyperlinked references to
 /// those types. Works for indexed records and std:: types found in the map above.
+/// Every record named in a type is linked, including template arguments like MyType in std::vector<MyType>.
+///
+/// The links are found in the unescaped proto first, each type being searched for after the previous one, and then
+/// the proto is escaped and the links are spliced in with a single pass over it.
 std::string hdoc::serde::getHyperlinkedFunctionProto(const std::string_view             proto,
-                                                     const hdoc::types::FunctionSymbol& f) {
-  std::string str = std::string(proto);
-
-  // Replace all of the html-sensitive characters with
-  str = hdoc::utils::replaceAll(str, "&", "&amp;");
-  str = hdoc::utils::replaceAll(str, "<", "&lt;");
-  str = hdoc::utils::replaceAll(str, ">", "&gt;");
-  str = hdoc::utils::replaceAll(str, "\"", "&quot;");
-  str = hdoc::utils::replaceAll(str, "'", "&apos;");
-
-  std::size_t index              = 0;
-  std::string bareReturnTypeName = getBareTypeName(f.returnType.name);
-  if (f.returnType.id.hashValue != 0) {
-    std::string replacement = "<a href=\"r" + f.returnType.id.str() + ".html\">" + bareReturnTypeName + "</a>";
-    index                   = hdoc::utils::replaceFirst(str, bareReturnTypeName, replacement, index);
-  }
-
-  if (bareReturnTypeName.substr(0, 5) == "std::") {
-    if (StdTypeURLMap.find(bareReturnTypeName) != StdTypeURLMap.end()) {
-      std::string replacement = "<a href=\"" + std::string(cppreferenceURL) + StdTypeURLMap.at(bareReturnTypeName) +
-                                "\">" + bareReturnTypeName + "</a>";
-      index = hdoc::utils::replaceFirst(str, bareReturnTypeName, replacement, index);
+                                                     const hdoc::types::FunctionSymbol& f,
+                                                     const bool                         sharded) {
+  std::vector<hdoc::serde::HTMLLink> links;
+  uint64_t                           pos = 0;
+
+  const auto linkType = [&](const hdoc::types::TypeRef& type) {
+    for (const auto& token : type.tokens) {
+      const std::string text = type.name.substr(token.start, token.length);
+      if (std::string url = getTokenURL(token, text, sharded); url != "") {
+        addTypeLink(links, proto, text, std::move(url), pos);
+      }
     }
-  }
-
-  for (const auto& param : f.params) {
-    std::string bareParamTypeName = getBareTypeName(param.type.name);
-    if (param.type.id.hashValue != 0) {
-      std::string replacement = "<a href=\"r" + param.type.id.str() + ".html\">" + bareParamTypeName + "</a>";
-      index                   = hdoc::utils::replaceFirst(str, bareParamTypeName, replacement, index);
+    if (type.tokens.size() > 0) {
+      return;
     }
 
-    if (bareParamTypeName.substr(0, 5) == "std::") {
-      if (StdTypeURLMap.find(bareParamTypeName) != StdTypeURLMap.end()) {
-        std::string replacement = "<a href=\"" + std::string(cppreferenceURL) + StdTypeURLMap.at(bareParamTypeName) +
-                                  "\">" + bareParamTypeName + "</a>";
-        index = hdoc::utils::replaceFirst(str, bareParamTypeName, replacement, index);
-      }
+    // Types without tokens, e.g. ones built by hand rather than by the matchers, only have their bare name linked
+    const std::string bareTypeName = getBareTypeName(type.name);
+    if (std::string url = getTypeURL(type, sharded); url != "") {
+      addTypeLink(links, proto, bareTypeName, std::move(url), pos);
     }
+    if (std::string url = getStdTypeURL(bareTypeName); url != "") {
+      addTypeLink(links, proto, bareTypeName, std::move(url), pos);
+    }
+  };
+
+  linkType(f.returnType);
+  for (const auto& param : f.params) {
+    linkType(param.type);
   }
 
+  std::string str;
+  hdoc::serde::appendLinkedHTML(str, proto, links);
   return str;
 }
 
 /// Returns the typename as raw HTML with hyperlinks where possible.
-/// Indexed types are hyperlinked to, as are certain std:: types.
+/// Indexed types are hyperlinked to, as are types from imported tag files and certain std:: types.
 /// All others are returned without hyperlinks as the plain type name.
-static std::string getHyperlinkedTypeName(const hdoc::types::TypeRef& type) {
-  std::string fullTypeName = type.name;
-  std::string bareTypeName = hdoc::serde::getBareTypeName(fullTypeName);
-
-  fullTypeName = hdoc::serde::clangFormat(fullTypeName);
-  fullTypeName = hdoc::utils::replaceAll(fullTypeName, "&", "&amp;");
-  fullTypeName = hdoc::utils::replaceAll(fullTypeName, "<", "&lt;");
-  fullTypeName = hdoc::utils::replaceAll(fullTypeName, ">", "&gt;");
-  fullTypeName = hdoc::utils::replaceAll(fullTypeName, "\"", "&quot;");
-  fullTypeName = hdoc::utils::replaceAll(fullTypeName, "'", "&apos;");
-
-  if (type.id.raw() == 0) {
-    // If it's a std:: type, then try to link to its cppreference page.
-    if (bareTypeName.substr(0, 5) == "std::" && StdTypeURLMap.find(bareTypeName) != StdTypeURLMap.end()) {
-      std::string replacement =
-          "<a href=\"" + std::string(cppreferenceURL) + StdTypeURLMap.at(bareTypeName) + "\">" + bareTypeName + "</a>";
-      hdoc::utils::replaceFirst(fullTypeName, bareTypeName, replacement);
-
-      return fullTypeName;
-    }
-    // Otherwise, return it as-is.
-    else {
-      return fullTypeName;
-    }
+std::string hdoc::serde::getHyperlinkedTypeName(const hdoc::types::TypeRef& type, const bool sharded) {
+  const std::string fullTypeName = hdoc::serde::formatTypeName(type.name);
+  if (type.tokens.size() > 0) {
+    std::string str;
+    hdoc::serde::appendLinkedHTML(str, fullTypeName, getTokenLinks(type, fullTypeName, sharded));
+    return str;
+  }
+
+  // Types without tokens only have their bare name linked
+  const std::string                  bareTypeName = hdoc::serde::getBareTypeName(type.name);
+  std::vector<hdoc::serde::HTMLLink> links;
+  std::string                        url = getTypeURL(type, sharded);
+  if (url == "") {
+    url = getStdTypeURL(bareTypeName);
+  }
+  if (url != "") {
+    uint64_t pos = 0;
+    addTypeLink(links, fullTypeName, bareTypeName, std::move(url), pos);
   }
-  // The type is in the database, so we link to it.
-  else {
-    std::string replacement = "<a href=\"r" + type.id.str() + ".html\">" + bareTypeName + "</a>";
-    hdoc::utils::replaceFirst(fullTypeName, bareTypeName, replacement);
-    return fullTypeName;
+
+  std::string str;
+  hdoc::serde::appendLinkedHTML(str, fullTypeName, links);
+  return str;
+}
+
+/// Returns the calling thread's buffer for rendering a page into.
+/// It's emptied, but keeps its capacity from a page that's already been written so that it rarely needs to grow.
+static std::string& getPageBuffer() {
+  thread_local std::string buffer;
+  buffer.clear();
+  return buffer;
+}
+
+/// Start a page by emitting the page shell up to and including its title.
+/// Pages in a shard subdirectory get a <base> element, so that their links resolve against the output directory in
+/// the same way as those of every other page.
+static void startPage(hdoc::serde::HTMLEmitter&     html,
+                      const hdoc::serde::PageShell& shell,
+                      const std::string_view        title,
+                      const bool                    inSubdirectory = false) {
+  html.raw(shell.prefix);
+  if (inSubdirectory) {
+    html.open("base").attr("href", "../").close();
   }
+  html.element("title", title).raw(shell.middle);
 }
 
-/// Returns an HTML node indicating where the s is declared.
-/// A hyperlink to the exact line in the source file (for GitHub and GitLab) is returned
+/// Returns a link to an anchor on the page at pageURL.
+/// Because of their <base> element, sharded pages need their own URL in links to their anchors. Other pages use a
+/// bare fragment.
+static std::string getAnchorLink(const std::string& pageURL, const std::string& anchor, const bool sharded) {
+  return (sharded ? pageURL : "") + "#" + anchor;
+}
+
+/// Finish a page started with startPage() and queue it to be written to path, along with the hash of its inputs.
+/// The buffer is handed over to output, and replaced with one that's already been written.
+static void finishPage(hdoc::serde::HTMLEmitter&     html,
+                       const hdoc::serde::PageShell& shell,
+                       std::string&                  buffer,
+                       hdoc::serde::OutputWriter&    output,
+                       const std::filesystem::path&  path,
+                       const uint64_t                inputs = 0) {
+  html.raw(shell.suffix);
+  output.write(path, std::exchange(buffer, output.acquireBuffer()), inputs);
+}
+
+/// Emits a paragraph indicating where the s is declared.
+/// A hyperlink to the exact line in the source file (for GitHub and GitLab) is emitted
 /// if gitRepoURL is provided.
-static CTML::Node getDeclaredAtNode(const hdoc::types::Symbol& s, const std::string_view gitRepoURL = "") {
-  auto p = CTML::Node("p", "Declared at: ");
+static void
+printDeclaredAt(hdoc::serde::HTMLEmitter& html, const hdoc::types::Symbol& s, const std::string_view gitRepoURL = "") {
+  html.open("p").text("Declared at: ");
   if (gitRepoURL == "") {
-    return p.AddChild(CTML::Node("span.is-family-code", s.file + ":" + std::to_string(s.line)));
+    html.element("span.is-family-code", s.file + ":" + std::to_string(s.line));
   } else {
-    return p.AddChild(CTML::Node("a.is-family-code", s.file + ":" + std::to_string(s.line))
-                          .SetAttr("href", std::string(gitRepoURL) + s.file + "#L" + std::to_string(s.line)));
+    html.open("a.is-family-code")
+        .attr("href", std::string(gitRepoURL) + s.file + "#L" + std::to_string(s.line))
+        .text(s.file + ":" + std::to_string(s.line))
+        .close();
   }
+  html.close();
 }
 
-/// Creates a Bulma breadcrumb node to make the provenance of the current symbol more clear and aid in navigation.
-static CTML::Node
-getBreadcrumbNode(const std::string& prefix, const hdoc::types::Symbol& s, const hdoc::types::Index& index) {
+/// Emits a Bulma breadcrumb to make the provenance of the current symbol more clear and aid in navigation.
+static void printBreadcrumbs(hdoc::serde::HTMLEmitter&  html,
+                             const std::string&         prefix,
+                             const hdoc::types::Symbol& s,
+                             const hdoc::types::Index&  index,
+                             const bool                 sharded) {
   // Symbols that have no parents don't have any breadcrumbs.
   if (s.parentNamespaceID.raw() == 0) {
-    return CTML::Node();
-  }
-
-  auto nav = CTML::Node("nav.breadcrumb has-arrow-separator").SetAttr("aria-label", "breadcrumbs");
-  auto ul  = CTML::Node("ul");
-
-  struct ParentSymbol {
-    std::string         symbolType;
-    hdoc::types::Symbol symbol;
-  };
-
-  // Construct a LIFO stack of parents for the current symbol.
-  // LIFO is used because we need to print the nodes into HTML in reverse order.
-  std::stack<ParentSymbol> stack;
-  hdoc::types::Symbol      parent = s;
-  while (true) {
-    if (index.namespaces.contains(parent.parentNamespaceID)) {
-      const auto& newParent = index.namespaces.entries.at(parent.parentNamespaceID);
-      stack.push({"namespace", newParent});
-      parent = newParent;
-    } else if (index.records.contains(parent.parentNamespaceID)) {
-      const auto& newParent = index.records.entries.at(parent.parentNamespaceID);
-      stack.push({newParent.type, newParent});
-      parent = newParent;
-    } else {
-      break;
-    }
+    return;
   }
 
-  // Create the HTML nodes for the parent symbols of the current node.
-  while (!stack.empty()) {
-    const auto parent = stack.top();
-    stack.pop();
+  html.open("nav.breadcrumb has-arrow-separator").attr("aria-label", "breadcrumbs").open("ul");
 
-    auto li = CTML::Node("li");
-    auto a  = CTML::Node();
-    if (parent.symbolType == "namespace") {
-      a = CTML::Node("a").SetAttr("href", "namespaces.html#" + parent.symbol.ID.str());
-    } else {
-      a = CTML::Node("a").SetAttr("href", "r" + parent.symbol.ID.str() + ".html");
+  // Emit the parent symbols of the current node, outermost first.
+  if (const auto lineage = index.lineages.find(s.parentNamespaceID); lineage != index.lineages.end()) {
+    for (const auto& id : lineage->second) {
+      html.open("li").open("a");
+      if (const auto ns = index.namespaces.entries.find(id); ns != index.namespaces.entries.end()) {
+        html.attr("href", "namespaces.html#" + id.str()).element("span", "namespace " + ns->second.name);
+      } else {
+        const auto& c = index.records.entries.at(id);
+        html.attr("href", c.url(sharded)).element("span", c.type + " " + c.name);
+      }
+      html.close().close();
     }
-    auto span = CTML::Node("span", parent.symbolType + " " + parent.symbol.name);
-
-    ul.AddChild(li.AddChild(a.AddChild(span)));
   }
 
   // Add the final breadcrumb, which is the actual symbol itself.
-  auto li   = CTML::Node("li.is-active");
-  auto a    = CTML::Node("a").SetAttr("aria-current", "page" + s.ID.str());
-  auto span = CTML::Node("span", prefix + " " + s.name);
-  ul.AddChild(li.AddChild(a.AddChild(span)));
+  html.open("li.is-active").open("a").attr("aria-current", "page" + s.ID.str());
+  html.element("span", prefix + " " + s.name).close().close();
 
-  return nav.AddChild(ul);
+  html.close().close();
 }
 
-/// Print a function to main
-static void printFunction(const hdoc::types::FunctionSymbol& f, CTML::Node& main, const std::string_view gitRepoURL) {
+/// Print a function to html, on the page at pageURL
+static void printFunction(const hdoc::types::FunctionSymbol& f,
+                          hdoc::serde::HTMLEmitter&          html,
+                          const std::string_view             gitRepoURL,
+                          const std::string&                 pageURL,
+                          const bool                         sharded) {
   // Print function return type, name, and parameters as section header
-  std::string proto = hdoc::serde::getHyperlinkedFunctionProto(hdoc::serde::clangFormat(f.proto), f);
-  auto        inner = CTML::Node("code.hdoc-function-code.language-cpp").AppendRawHTML(proto);
-  main.AddChild(CTML::Node("h3#" + f.ID.str())
-                    .AddChild(CTML::Node("pre.p-0.hdoc-pre-parent")
-                                  .AddChild(CTML::Node("a.is-size-4", "¶")
-                                                .SetAttr("class", "hdoc-permalink-icon")
-                                                .SetAttr("href", "#" + f.ID.str()))
-                                  .AddChild(inner)));
+  std::string proto = hdoc::serde::getHyperlinkedFunctionProto(hdoc::serde::formatFunctionProto(f), f, sharded);
+  html.open("h3").attr("id", f.ID.str()).open("pre.p-0.hdoc-pre-parent");
+  html.open("a.hdoc-permalink-icon").attr("href", getAnchorLink(pageURL, f.ID.str(), sharded)).text("¶").close();
+  html.open("code.hdoc-function-code.language-cpp").raw(proto).close();
+  html.close().close();
 
   // Print function description only if there's an associated comment
   if (f.briefComment != "" || f.docComment != "") {
-    main.AddChild(CTML::Node("h4", "Description"));
+    html.element("h4", "Description");
   }
 
   if (f.briefComment != "") {
-    main.AddChild(CTML::Node("p", f.briefComment));
+    html.element("p", f.briefComment);
   }
   if (f.docComment != "") {
-    main.AddChild(CTML::Node("p", f.docComment));
+    html.element("p", f.docComment);
   }
-  main.AddChild(getDeclaredAtNode(f, gitRepoURL));
+  printDeclaredAt(html, f, gitRepoURL);
 
   // Print function parameters (with type, name, default value, and comment) as a list
   if (f.templateParams.size() > 0) {
-    main.AddChild(CTML::Node("h4", "Templates"));
-    CTML::Node dl("dl");
-
-    for (auto tparam : f.templateParams) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(tparam.type);
-      dt.AddChild(CTML::Node("b", " " + tparam.name));
-
+    html.element("h4", "Templates").open("dl");
+    for (const auto& tparam : f.templateParams) {
+      html.open("dt.is-family-code").raw(tparam.type).element("b", " " + tparam.name);
       if (tparam.defaultValue != "") {
-        dt.AppendText(" = " + tparam.defaultValue);
+        html.text(" = " + tparam.defaultValue);
       }
-      dl.AddChild(dt);
+      html.close();
       if (tparam.docComment != "") {
-        dl.AddChild(CTML::Node("dd", tparam.docComment));
+        html.element("dd", tparam.docComment);
       }
     }
-    main.AddChild(dl);
+    html.close();
   }
 
   // Print function parameters (with type, name, default value, and comment) as a list
   if (f.params.size() > 0) {
-    main.AddChild(CTML::Node("h4", "Parameters"));
-    CTML::Node dl("dl");
-
-    for (auto param : f.params) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(getHyperlinkedTypeName(param.type));
-      dt.AddChild(CTML::Node("b", " " + param.name));
-
+    html.element("h4", "Parameters").open("dl");
+    for (const auto& param : f.params) {
+      html.open("dt.is-family-code")
+          .raw(hdoc::serde::getHyperlinkedTypeName(param.type, sharded))
+          .element("b", " " + param.name);
       if (param.defaultValue != "") {
-        dt.AppendText(" = " + param.defaultValue);
+        html.text(" = " + param.defaultValue);
       }
-      dl.AddChild(dt);
+      html.close();
       if (param.docComment != "") {
-        dl.AddChild(CTML::Node("dd", param.docComment));
+        html.element("dd", param.docComment);
       }
     }
-    main.AddChild(dl);
+    html.close();
   }
 
   // Return value description
   if (f.returnTypeDocComment != "") {
-    main.AddChild(CTML::Node("h4", "Returns"));
-    main.AddChild(CTML::Node("p", f.returnTypeDocComment));
+    html.element("h4", "Returns");
+    html.element("p", f.returnTypeDocComment);
   }
 }
 
-/// Print all of the functions that aren't record members in a project
-void hdoc::serde::HTMLWriter::printFunctions() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Functions"));
+/// Print a function that isn't a record member to its own page
+void hdoc::serde::HTMLWriter::printFunction(const hdoc::types::FunctionSymbol& f) const {
+  const bool        sharded = this->cfg->shardPages;
+  const std::string pageURL = f.url(sharded);
+  std::string&      buffer  = getPageBuffer();
+  HTMLEmitter       html(buffer);
+  startPage(html, this->shell, "function " + f.name + ": " + this->cfg->getPageTitleSuffix(), sharded);
+  printBreadcrumbs(html, "function", f, *this->index, sharded);
+  html.open("main.content");
+  ::printFunction(f, html, this->cfg->gitRepoURL, pageURL, sharded);
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / pageURL, this->getPageInputs(f));
+}
+
+/// Print the overview page listing all of the functions that aren't record members
+void hdoc::serde::HTMLWriter::printFunctionsOverview() const {
+  std::string& buffer = getPageBuffer();
+  HTMLEmitter  html(buffer);
+  startPage(html, this->shell, "Functions: " + this->cfg->getPageTitleSuffix());
+  html.open("main.content").element("h1", "Functions").element("h2", "Overview");
 
   // Print a bullet list of functions
-  uint64_t   numFunctions = 0; // Number of functions that aren't methods
-  CTML::Node ul("ul");
-  for (const auto& id : getSortedIDs(map2vec(this->index->functions), this->index->functions)) {
-    const auto& f = this->index->functions.entries.at(id);
-    if (f.isRecordMember) {
-      continue;
-    }
-    numFunctions += 1;
-    ul.AddChild(CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", f.name).SetAttr("href", f.url()))
-                    .AppendText(getSymbolBlurb(f)));
-    CTML::Node page("main");
-    this->pool.async(
-        [&](const hdoc::types::FunctionSymbol& func, CTML::Node pg) {
-          printFunction(func, pg, this->cfg->gitRepoURL);
-          printNewPage(*this->cfg,
-                       pg,
-                       this->cfg->outputDir / func.url(),
-                       "function " + func.name + ": " + this->cfg->getPageTitleSuffix(),
-                       getBreadcrumbNode("function", func, *this->index));
-        },
-        f,
-        page);
-  }
-  this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
+  const auto&    sortedIDs    = this->index->functions.sortedIDs;
+  const uint64_t numFunctions = std::count_if(sortedIDs.begin(), sortedIDs.end(), [&](const auto& id) {
+    return this->index->functions.entries.at(id).isRecordMember == false;
+  }); // Number of functions that aren't methods
   if (numFunctions == 0) {
-    main.AddChild(CTML::Node("p", "No functions were declared in this project."));
+    html.element("p", "No functions were declared in this project.");
   } else {
-    main.AddChild(ul);
+    html.open("ul");
+    for (const auto& id : sortedIDs) {
+      const auto& f = this->index->functions.entries.at(id);
+      if (f.isRecordMember) {
+        continue;
+      }
+      html.open("li").open("a.is-family-code").attr("href", f.url(this->cfg->shardPages)).text(f.name).close();
+      html.text(getSymbolBlurb(f)).close();
+    }
+    html.close();
   }
-  printNewPage(
-      *this->cfg, main, this->cfg->outputDir / "functions.html", "Functions: " + this->cfg->getPageTitleSuffix());
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / "functions.html");
 }
 
-static std::vector<hdoc::types::RecordSymbol::BaseRecord> getInheritedSymbols(const hdoc::types::Index*        index,
-                                                                              const hdoc::types::RecordSymbol& root) {
-  std::vector<hdoc::types::RecordSymbol::BaseRecord> vec   = {};
-  std::stack<hdoc::types::RecordSymbol::BaseRecord>  stack = {};
-  for (const auto& base : root.baseRecords) {
-    stack.push(base);
-  }
-
-  // Do a depth-first traversal of the parents of root
-  while (!stack.empty()) {
-    const hdoc::types::RecordSymbol::BaseRecord record = stack.top();
-    stack.pop();
-
-    // Quit if the base record is in std namespace
-    if (index->records.contains(record.id) == false) {
-      continue;
-    }
-
-    // Records inherited privately are ignored and their children are not traversed
-    // This is suboptimal since an immediate privately inherited parent of root might have some important members
-    // we'd like to document; for now I'm not implementing that since that edge case would balloon code complexity
-    if (record.access == clang::AS_private) {
-      continue;
-    }
-
-    vec.push_back(record);
-
-    // Add children to stack for traversing
-    const auto& c = index->records.entries.at(record.id);
-    for (const auto& baseRecord : c.baseRecords) {
-      stack.push(baseRecord);
-    }
-  }
-  return vec;
+/// Returns the IDs of the records that c inherits from, which are computed once by Indexer::computeAncestry()
+static const std::vector<hdoc::types::SymbolID>& getInheritedRecordIDs(const hdoc::types::Index&        index,
+                                                                       const hdoc::types::RecordSymbol& c) {
+  static const std::vector<hdoc::types::SymbolID> none;
+  const auto                                      it = index.inheritedRecordIDs.find(c.ID);
+  return it == index.inheritedRecordIDs.end() ? none : it->second;
 }
 
-static void printMemberVariables(const hdoc::types::RecordSymbol& c, CTML::Node& main, const bool& isInherited) {
-  CTML::Node dl("dl");
-  uint64_t   numVars = 0;
+static void printMemberVariables(const hdoc::types::RecordSymbol& c,
+                                 hdoc::serde::HTMLEmitter&        html,
+                                 const bool&                      isInherited,
+                                 const bool                       sharded) {
+  // Private variables aren't inherited, and nothing is printed if there aren't any variables left
+  const uint64_t numVars = std::count_if(c.vars.begin(), c.vars.end(), [&](const hdoc::types::MemberVariable& var) {
+    return isInherited == false || var.access != clang::AS_private;
+  });
+  if (numVars == 0) {
+    return;
+  }
 
+  if (isInherited) {
+    html.open("p").text("Inherited from ").open("a").attr("href", c.url(sharded)).text(c.name).close();
+    html.text(":").close();
+  }
+  html.open("dl");
   for (const hdoc::types::MemberVariable& var : c.vars) {
     if (isInherited == true && var.access == clang::AS_private) {
       continue;
@@ -628,49 +818,40 @@ static void printMemberVariables(const hdoc::types::RecordSymbol& c, CTML::Node&
     std::string preamble = to_string(var.access);
     preamble += var.isStatic ? " static " : " ";
 
-    CTML::Node dt;
     // Print the access, type, name, and doc comment if it exists
     if (isInherited == false) {
-      dt     = CTML::Node("dt.is-family-code").AppendRawHTML(preamble + " " + getHyperlinkedTypeName(var.type) + " ");
-      auto b = CTML::Node("b", var.name);
-      dt.AddChild(b);
-      dt.SetAttr("id", "var_" + var.name);
+      html.open("dt.is-family-code").attr("id", "var_" + var.name);
+      html.raw(preamble + " " + hdoc::serde::getHyperlinkedTypeName(var.type, sharded) + " ").element("b", var.name);
     }
     // Inherited variables get a bullet point and link to the description in the parent record
     else {
-      dt = CTML::Node("dt.is-family-code");
-      const auto a =
-          CTML::Node("a", preamble).SetAttr("href", c.url() + "#var_" + var.name).AddChild(CTML::Node("b", var.name));
-      dt.AddChild(a);
+      html.open("dt.is-family-code").open("a").attr("href", c.url(sharded) + "#var_" + var.name);
+      html.text(preamble).element("b", var.name).close();
     }
     if (var.defaultValue != "") {
-      dt.AppendText(" = " + var.defaultValue);
+      html.text(" = " + var.defaultValue);
     }
-
-    dl.AddChild(dt);
+    html.close();
 
     if (isInherited == false && var.docComment != "") {
-      dl.AddChild(CTML::Node("dd", var.docComment));
+      html.element("dd", var.docComment);
     }
-
-    numVars += 1;
-  }
-
-  if (numVars > 0) {
-    if (isInherited) {
-      main.AddChild(CTML::Node("p", "Inherited from ")
-                        .AddChild(CTML::Node("a", c.name).SetAttr("href", c.url()))
-                        .AppendText(":"));
-    }
-    main.AddChild(dl);
   }
+  html.close();
 }
 
 /// Print a list of inherited methods for the given record, truncating the method declaration
-static void
-printInheritedMethods(const hdoc::types::Index* index, const hdoc::types::RecordSymbol& c, CTML::Node& main) {
-  auto ul = CTML::Node("ul");
+static void printInheritedMethods(const hdoc::types::Index*        index,
+                                  const hdoc::types::RecordSymbol& c,
+                                  hdoc::serde::HTMLEmitter&        html,
+                                  const bool                       sharded) {
+  if (c.methodIDs.size() == 0) {
+    return;
+  }
 
+  html.open("p").text("Inherited from ").open("a").attr("href", c.url(sharded)).text(c.name).close();
+  html.text(":").close();
+  html.open("ul");
   for (const auto& methodID : getSortedIDs(c.methodIDs, index->functions)) {
     const auto& f = index->functions.entries.at(methodID);
     // Skip private functions and ctors/dtors that aren't inherited
@@ -678,305 +859,621 @@ printInheritedMethods(const hdoc::types::Index* index, const hdoc::types::Record
       continue;
     }
 
-    const auto li = CTML::Node("li.is-family-code")
-                        .AddChild(CTML::Node("a", to_string(f.access) + " ")
-                                      .SetAttr("href", c.url() + "#" + f.ID.str())
-                                      .AddChild(CTML::Node("b", f.name)));
-    ul.AddChild(li);
-  }
-
-  if (c.methodIDs.size() > 0) {
-    main.AddChild(
-        CTML::Node("p", "Inherited from ").AddChild(CTML::Node("a", c.name).SetAttr("href", c.url())).AppendText(":"));
-    main.AddChild(ul);
+    html.open("li.is-family-code").open("a").attr("href", c.url(sharded) + "#" + f.ID.str());
+    html.text(to_string(f.access) + " ").element("b", f.name).close().close();
   }
+  html.close();
 }
 
-/// Print a record to main
+/// Print a record to its own page
 void hdoc::serde::HTMLWriter::printRecord(const hdoc::types::RecordSymbol& c) const {
-  CTML::Node main("main");
-
+  const bool        sharded   = this->cfg->shardPages;
+  const std::string pageURL   = c.url(sharded);
+  std::string&      buffer    = getPageBuffer();
+  HTMLEmitter       html(buffer);
   const std::string pageTitle = c.type + " " + c.name;
-  main.AddChild(CTML::Node("h1", pageTitle));
+  startPage(html, this->shell, pageTitle + ": " + this->cfg->getPageTitleSuffix(), sharded);
+  printBreadcrumbs(html, c.type, c, *this->index, sharded);
+  html.open("main.content").element("h1", pageTitle);
 
   // Full declaration
-  main.AddChild(CTML::Node("h2", "Declaration"));
-  main.AddChild(CTML::Node("pre.p-0").AddChild(
-      CTML::Node("code.hdoc-record-code.language-cpp",
-                 hdoc::serde::clangFormat(c.proto, 70) + " { /* full declaration omitted */ };")));
+  html.element("h2", "Declaration");
+  html.open("pre.p-0")
+      .element("code.hdoc-record-code.language-cpp",
+               hdoc::serde::formatRecordProto(c) + " { /* full declaration omitted */ };")
+      .close();
 
   if (c.briefComment != "" || c.docComment != "") {
-    main.AddChild(CTML::Node("h2", "Description"));
+    html.element("h2", "Description");
   }
   if (c.briefComment != "") {
-    main.AddChild(CTML::Node("p", c.briefComment));
+    html.element("p", c.briefComment);
   }
   if (c.docComment != "") {
-    main.AddChild(CTML::Node("p", c.docComment));
+    html.element("p", c.docComment);
   }
-  main.AddChild(getDeclaredAtNode(c, this->cfg->gitRepoURL));
+  printDeclaredAt(html, c, this->cfg->gitRepoURL);
 
   // Base records
   uint64_t count = 0;
   if (c.baseRecords.size() > 0) {
-    auto baseP = CTML::Node("p", "Inherits from: ");
+    html.open("p").text("Inherits from: ");
     for (const auto& baseRecord : c.baseRecords) {
       if (count > 0) {
-        baseP.AppendText(", ");
+        html.text(", ");
       }
       // Check if type is a string, indicating it's a std record that isn't in the DB
       if (this->index->records.contains(baseRecord.id) == false) {
-        baseP.AppendText(baseRecord.name);
+        html.text(baseRecord.name);
       } else {
         const auto& p = this->index->records.entries.at(baseRecord.id);
-        baseP.AddChild(CTML::Node("a", p.name).SetAttr("href", p.url()));
+        html.open("a").attr("href", p.url(sharded)).text(p.name).close();
       }
       count++;
     }
-    main.AddChild(baseP);
+    html.close();
   }
 
   // Print function parameters (with type, name, default value, and comment) as a list
   if (c.templateParams.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Templates"));
-    CTML::Node dl("dl");
-
-    for (auto tparam : c.templateParams) {
-      auto dt = CTML::Node("dt.is-family-code").AppendRawHTML(tparam.type);
-      dt.AddChild(CTML::Node("b", " " + tparam.name));
-
+    html.element("h2", "Templates").open("dl");
+    for (const auto& tparam : c.templateParams) {
+      html.open("dt.is-family-code").raw(tparam.type).element("b", " " + tparam.name);
       if (tparam.defaultValue != "") {
-        dt.AppendText(" = " + tparam.defaultValue);
+        html.text(" = " + tparam.defaultValue);
       }
-      dl.AddChild(dt);
+      html.close();
       if (tparam.docComment != "") {
-        dl.AddChild(CTML::Node("dd", tparam.docComment));
+        html.element("dd", tparam.docComment);
       }
     }
-    main.AddChild(dl);
+    html.close();
   }
 
   // Print regular member variables
   bool hasMemberVariableHeading = false;
   if (c.vars.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Member Variables"));
+    html.element("h2", "Member Variables");
     hasMemberVariableHeading = true;
-    printMemberVariables(c, main, false);
+    printMemberVariables(c, html, false, sharded);
   }
 
   // Print inherited member variables
-  const auto inheritedRecords = getInheritedSymbols(this->index, c);
-  for (const auto& base : inheritedRecords) {
-    const auto& ic = this->index->records.entries.at(base.id);
+  const auto& inheritedRecordIDs = getInheritedRecordIDs(*this->index, c);
+  for (const auto& id : inheritedRecordIDs) {
+    const auto& ic = this->index->records.entries.at(id);
     if (hasMemberVariableHeading == false && ic.vars.size() > 0) {
-      main.AddChild(CTML::Node("h2", "Member Variables"));
+      html.element("h2", "Member Variables");
       hasMemberVariableHeading = true;
     }
-    printMemberVariables(ic, main, true);
+    printMemberVariables(ic, html, true, sharded);
   }
 
   // Method overview in list form
   const auto& sortedMethodIDs          = getSortedIDs(c.methodIDs, this->index->functions);
   bool        hasMethodOverviewHeading = false;
   if (sortedMethodIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Method Overview"));
+    html.element("h2", "Method Overview");
     hasMethodOverviewHeading = true;
-    CTML::Node ul("ul");
+    html.open("ul");
     for (auto methodID : sortedMethodIDs) {
-      const hdoc::types::FunctionSymbol m = this->index->functions.entries.at(methodID);
+      const hdoc::types::FunctionSymbol& m = this->index->functions.entries.at(methodID);
 
       // Divide up the full function declaration so its name can be bold in the HTML
       const uint64_t    nameLen  = m.name.size();
       const std::string preName  = to_string(m.access) + " " + m.proto.substr(0, m.nameStart) + " ";
       const std::string postName = m.proto.substr(m.nameStart + nameLen, m.proto.size() - m.nameStart - nameLen);
 
-      const auto li = CTML::Node("li.is-family-code", preName)
-                          .AddChild(CTML::Node("a").SetAttr("href", "#" + m.ID.str()).AddChild(CTML::Node("b", m.name)))
-                          .AppendText(postName);
-      ul.AddChild(li);
+      html.open("li.is-family-code").text(preName);
+      html.open("a").attr("href", getAnchorLink(pageURL, m.ID.str(), sharded)).element("b", m.name).close();
+      html.text(postName).close();
     }
-    main.AddChild(ul);
+    html.close();
   }
 
   // Add inherited methods to the list
-  for (const auto& base : inheritedRecords) {
-    const auto& ic = this->index->records.entries.at(base.id);
+  for (const auto& id : inheritedRecordIDs) {
+    const auto& ic = this->index->records.entries.at(id);
     if (hasMethodOverviewHeading == false && c.methodIDs.size() > 0) {
-      main.AddChild(CTML::Node("h2", "Method Overview"));
+      html.element("h2", "Method Overview");
       hasMethodOverviewHeading = true;
     }
-    printInheritedMethods(this->index, ic, main);
+    printInheritedMethods(this->index, ic, html, sharded);
   }
 
   // List of methods with full information
   if (sortedMethodIDs.size() > 0) {
-    main.AddChild(CTML::Node("h2", "Methods"));
+    html.element("h2", "Methods");
     for (const auto& methodID : sortedMethodIDs) {
       // TODO: get to the bottom of what's causing empty method decls to appear in Writer.hpp
       // For now this hack just avoids printing them, but this shouldn't be necessary
       if (index->functions.contains(methodID) == false) {
         continue;
       }
-      printFunction(this->index->functions.entries.at(methodID), main, this->cfg->gitRepoURL);
+      ::printFunction(this->index->functions.entries.at(methodID), html, this->cfg->gitRepoURL, pageURL, sharded);
     }
   }
 
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / c.url(),
-               pageTitle + ": " + this->cfg->getPageTitleSuffix(),
-               getBreadcrumbNode(c.type, c, *this->index));
+  // Functions and records that refer to this record
+  if (c.usedByFunctionIDs.size() > 0 || c.usedByRecordIDs.size() > 0) {
+    html.element("h2", "Used By").open("ul");
+    for (const auto& id : getSortedIDs(c.usedByRecordIDs, this->index->records)) {
+      const auto& r = this->index->records.entries.at(id);
+      html.open("li").open("a.is-family-code").attr("href", r.url(sharded)).text(r.type + " " + r.name).close();
+      html.close();
+    }
+    for (const auto& id : getSortedIDs(c.usedByFunctionIDs, this->index->functions)) {
+      const auto& f = this->index->functions.entries.at(id);
+      // Methods are documented on their record's page
+      if (f.isRecordMember && this->index->records.contains(f.parentNamespaceID)) {
+        const auto& parent = this->index->records.entries.at(f.parentNamespaceID);
+        html.open("li").open("a.is-family-code").attr("href", parent.url(sharded) + "#" + f.ID.str());
+        html.text(parent.name + "::" + f.name).close().close();
+      } else if (f.isRecordMember == false) {
+        html.open("li").open("a.is-family-code").attr("href", f.url(sharded)).text(f.name).close().close();
+      }
+    }
+    html.close();
+  }
+
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / pageURL, this->getPageInputs(c));
 }
 
-/// Print all of the records in a project
-void hdoc::serde::HTMLWriter::printRecords() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Records"));
+/// Print the overview page listing all of the records in a project
+void hdoc::serde::HTMLWriter::printRecordsOverview() const {
+  std::string& buffer = getPageBuffer();
+  HTMLEmitter  html(buffer);
+  startPage(html, this->shell, "Records: " + this->cfg->getPageTitleSuffix());
+  html.open("main.content").element("h1", "Records").element("h2", "Overview");
 
   // List of all the records defined, with links to the individual record HTML
-  CTML::Node ul("ul");
-  for (const auto& id : getSortedIDs(map2vec(this->index->records), this->index->records)) {
-    const auto& c = this->index->records.entries.at(id);
-    ul.AddChild(CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", c.type + " " + c.name).SetAttr("href", c.url()))
-                    .AppendText(getSymbolBlurb(c)));
-    this->pool.async([&](const hdoc::types::RecordSymbol& cls) { printRecord(cls); }, c);
-  }
-  this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
   if (this->index->records.entries.size() == 0) {
-    main.AddChild(CTML::Node("p", "No records were declared in this project."));
+    html.element("p", "No records were declared in this project.");
   } else {
-    main.AddChild(ul);
+    html.open("ul");
+    for (const auto& id : this->index->records.sortedIDs) {
+      const auto& c = this->index->records.entries.at(id);
+      html.open("li").open("a.is-family-code").attr("href", c.url(this->cfg->shardPages));
+      html.text(c.type + " " + c.name).close();
+      html.text(getSymbolBlurb(c)).close();
+    }
+    html.close();
   }
-  printNewPage(*this->cfg, main, this->cfg->outputDir / "records.html", "Records: " + this->cfg->getPageTitleSuffix());
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / "records.html");
 }
 
 /// Recursively print an single namespace and all of its children
-/// Should be tail-call optimized
-static CTML::Node printNamespace(const hdoc::types::NamespaceSymbol& ns, const hdoc::types::Index& index) {
+static void printNamespace(const hdoc::types::NamespaceSymbol& ns,
+                           const hdoc::types::Index&           index,
+                           hdoc::serde::HTMLEmitter&           html,
+                           const bool                          sharded) {
   // Base case: stop recursion when namespace has no further children
-  // and return an empty node, which will not be appended since we have a custom version of CTML
   if (ns.records.size() == 0 && ns.enums.size() == 0 && ns.namespaces.size() == 0) {
-    return CTML::Node("");
+    return;
   }
 
-  auto node  = CTML::Node("li.is-family-code#" + ns.ID.str(), ns.name);
-  auto subUL = CTML::Node("ul");
+  html.open("li.is-family-code").attr("id", ns.ID.str()).text(ns.name).open("ul");
 
   const std::vector<hdoc::types::SymbolID> childNamespaces = getSortedIDs(ns.namespaces, index.namespaces);
   const std::vector<hdoc::types::SymbolID> childRecords    = getSortedIDs(ns.records, index.records);
   const std::vector<hdoc::types::SymbolID> childEnums      = getSortedIDs(ns.enums, index.enums);
 
   for (const auto& childID : childNamespaces) {
-    auto childNode = printNamespace(index.namespaces.entries.at(childID), index);
-    subUL.AddChild(childNode);
+    printNamespace(index.namespaces.entries.at(childID), index, html, sharded);
   }
   for (const auto& childID : childRecords) {
-    const hdoc::types::RecordSymbol s = index.records.entries.at(childID);
-    subUL.AddChild(
-        CTML::Node("li.is-family-code").AddChild(CTML::Node("a", s.type + " " + s.name).SetAttr("href", s.url())));
+    const hdoc::types::RecordSymbol& s = index.records.entries.at(childID);
+    html.open("li.is-family-code").open("a").attr("href", s.url(sharded)).text(s.type + " " + s.name).close().close();
   }
   for (const auto& childID : childEnums) {
-    const hdoc::types::EnumSymbol s = index.enums.entries.at(childID);
-    subUL.AddChild(
-        CTML::Node("li.is-family-code").AddChild(CTML::Node("a", s.type + " " + s.name).SetAttr("href", s.url())));
+    const hdoc::types::EnumSymbol& s = index.enums.entries.at(childID);
+    html.open("li.is-family-code").open("a").attr("href", s.url(sharded)).text(s.type + " " + s.name).close().close();
   }
-  return node.AddChild(subUL);
+  html.close().close();
 }
 
 /// Print all of the namespaces in a project in a nice tree-view
 void hdoc::serde::HTMLWriter::printNamespaces() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Namespaces"));
-
-  CTML::Node namespaceTree("ul");
+  std::string& buffer = getPageBuffer();
+  HTMLEmitter  html(buffer);
+  startPage(html, this->shell, "Namespaces: " + this->cfg->getPageTitleSuffix());
+  html.open("main.content").element("h1", "Namespaces");
 
-  for (const auto& id : getSortedIDs(map2vec(this->index->namespaces), this->index->namespaces)) {
-    const auto& ns = this->index->namespaces.entries.at(id);
-    // Only recurse root namespaces (that have no parents)
-    if (ns.parentNamespaceID.raw() != 0) {
-      continue;
-    }
-    namespaceTree.AddChild(printNamespace(ns, *this->index));
-  }
   if (this->index->namespaces.entries.size() == 0) {
-    main.AddChild(CTML::Node("p", "No namespaces were declared in this project."));
+    html.element("p", "No namespaces were declared in this project.");
   } else {
-    main.AddChild(namespaceTree);
+    html.open("ul");
+    for (const auto& id : this->index->namespaces.sortedIDs) {
+      const auto& ns = this->index->namespaces.entries.at(id);
+      // Only recurse root namespaces (that have no parents)
+      if (ns.parentNamespaceID.raw() != 0) {
+        continue;
+      }
+      printNamespace(ns, *this->index, html, this->cfg->shardPages);
+    }
+    html.close();
   }
-  printNewPage(
-      *this->cfg, main, this->cfg->outputDir / "namespaces.html", "Namespaces: " + this->cfg->getPageTitleSuffix());
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / "namespaces.html");
 }
 
-/// Print an enum to main
+/// Print an enum to its own page
 void hdoc::serde::HTMLWriter::printEnum(const hdoc::types::EnumSymbol& e) const {
-  CTML::Node        main("main");
+  const bool        sharded   = this->cfg->shardPages;
+  std::string&      buffer    = getPageBuffer();
+  HTMLEmitter       html(buffer);
   const std::string pageTitle = e.type + " " + e.name;
-  main.AddChild(CTML::Node("h1", pageTitle));
+  startPage(html, this->shell, pageTitle + ": " + this->cfg->getPageTitleSuffix(), sharded);
+  printBreadcrumbs(html, e.type, e, *this->index, sharded);
+  html.open("main.content").element("h1", pageTitle);
 
   // Description
   if (e.briefComment != "" || e.docComment != "") {
-    main.AddChild(CTML::Node("h2", "Description"));
+    html.element("h2", "Description");
   }
   if (e.briefComment != "") {
-    main.AddChild(CTML::Node("p", e.briefComment));
+    html.element("p", e.briefComment);
   }
   if (e.docComment != "") {
-    main.AddChild(CTML::Node("p", e.docComment));
+    html.element("p", e.docComment);
   }
-  main.AddChild(getDeclaredAtNode(e, this->cfg->gitRepoURL));
+  printDeclaredAt(html, e, this->cfg->gitRepoURL);
 
   // Enum members in table format
-  main.AddChild(CTML::Node("h2", "Enumerators"));
+  html.element("h2", "Enumerators");
   if (e.members.size() > 0) {
-    // Table and table header nodes
-    CTML::Node table("table.table is-narrow is-hoverable");
-    CTML::Node table_header_row("tr");
-    table_header_row.AddChild(CTML::Node("th", "Name"));
-    table_header_row.AddChild(CTML::Node("th", "Value"));
-    table_header_row.AddChild(CTML::Node("th", "Comment"));
-    table.AddChild(table_header_row);
+    // Table and table header
+    html.open("table.table is-narrow is-hoverable").open("tr");
+    html.element("th", "Name").element("th", "Value").element("th", "Comment").close();
 
     // Table rows: one row per enum member
     for (const auto& member : e.members) {
-      CTML::Node table_row("tr");
-      table_row.AddChild(CTML::Node("td.is-family-code", member.name));
-      table_row.AddChild(CTML::Node("td.is-family-code", std::to_string(member.value)));
-      table_row.AddChild(CTML::Node("td", member.docComment));
-      table.AddChild(table_row);
+      html.open("tr");
+      html.element("td.is-family-code", member.name);
+      html.element("td.is-family-code", std::to_string(member.value));
+      html.element("td", member.docComment);
+      html.close();
     }
-    main.AddChild(table);
+    html.close();
   }
 
-  printNewPage(*this->cfg,
-               main,
-               this->cfg->outputDir / e.url(),
-               pageTitle + ": " + this->cfg->getPageTitleSuffix(),
-               getBreadcrumbNode(e.type, e, *this->index));
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / e.url(sharded), this->getPageInputs(e));
 }
 
-/// Print all of the enums in a project
-void hdoc::serde::HTMLWriter::printEnums() const {
-  CTML::Node main("main");
-  main.AddChild(CTML::Node("h1", "Enums"));
-
-  CTML::Node ul("ul");
-  for (const auto& id : getSortedIDs(map2vec(this->index->enums), this->index->enums)) {
-    const auto& e = this->index->enums.entries.at(id);
-    ul.AddChild(CTML::Node("li")
-                    .AddChild(CTML::Node("a.is-family-code", e.type + " " + e.name).SetAttr("href", e.url()))
-                    .AppendText(getSymbolBlurb(e)));
-    this->pool.async([&](const hdoc::types::EnumSymbol& en) { printEnum(en); }, e);
-  }
-  this->pool.wait();
-  main.AddChild(CTML::Node("h2", "Overview"));
+/// Print the overview page listing all of the enums in a project
+void hdoc::serde::HTMLWriter::printEnumsOverview() const {
+  std::string& buffer = getPageBuffer();
+  HTMLEmitter  html(buffer);
+  startPage(html, this->shell, "Enums: " + this->cfg->getPageTitleSuffix());
+  html.open("main.content").element("h1", "Enums").element("h2", "Overview");
+
   if (this->index->enums.entries.size() == 0) {
-    main.AddChild(CTML::Node("p", "No enums were declared in this project."));
+    html.element("p", "No enums were declared in this project.");
   } else {
-    main.AddChild(ul);
+    html.open("ul");
+    for (const auto& id : this->index->enums.sortedIDs) {
+      const auto& e = this->index->enums.entries.at(id);
+      html.open("li").open("a.is-family-code").attr("href", e.url(this->cfg->shardPages));
+      html.text(e.type + " " + e.name).close();
+      html.text(getSymbolBlurb(e)).close();
+    }
+    html.close();
+  }
+  html.close();
+  finishPage(html, this->shell, buffer, this->output, this->cfg->outputDir / "enums.html");
+}
+
+/// Accumulates everything a page is rendered from, and hashes it.
+/// The documented content of each symbol is covered by its fingerprint, so only what the fingerprint leaves out is
+/// added alongside it: where the symbol is declared, and the pages that it links to.
+class PageInputs {
+public:
+  PageInputs& add(const std::string_view str) {
+    this->buffer.append(str);
+    this->buffer.push_back('\0');
+    return *this;
+  }
+  PageInputs& add(const uint64_t value) {
+    this->buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    return *this;
+  }
+  PageInputs& add(const hdoc::types::Symbol& s) {
+    return this->add(s.fingerprint).add(s.ID.raw()).add(s.file).add(s.line);
+  }
+  PageInputs& add(const hdoc::types::TypeRef& type) {
+    this->add(type.id.raw()).add(type.externalURL);
+    for (const auto& token : type.tokens) {
+      this->add(token.id.raw()).add(token.externalURL);
+    }
+    return *this;
+  }
+  PageInputs& add(const hdoc::types::FunctionSymbol& f) {
+    this->add(static_cast<const hdoc::types::Symbol&>(f)).add(f.returnType);
+    for (const auto& param : f.params) {
+      this->add(param.type);
+    }
+    return *this;
+  }
+  uint64_t hash() const {
+    return llvm::xxHash64(this->buffer);
+  }
+
+private:
+  std::string buffer;
+};
+
+/// Returns a hash of what every page has in common: the page shell, and the settings that affect how pages are
+/// rendered
+static uint64_t getRenderKey(const hdoc::types::Config& cfg, const hdoc::serde::PageShell& shell) {
+  PageInputs inputs;
+  inputs.add(shell.prefix).add(shell.middle).add(shell.suffix);
+  return inputs.add(cfg.getPageTitleSuffix()).add(cfg.gitRepoURL).add(cfg.shardPages).hash();
+}
+
+/// Add the names of a symbol's parents, which are printed as its breadcrumbs
+static void addBreadcrumbInputs(PageInputs& inputs, const hdoc::types::Symbol& s, const hdoc::types::Index& index) {
+  inputs.add(s.parentNamespaceID.raw());
+  if (const auto lineage = index.lineages.find(s.parentNamespaceID); lineage != index.lineages.end()) {
+    for (const auto& id : lineage->second) {
+      if (const auto ns = index.namespaces.entries.find(id); ns != index.namespaces.entries.end()) {
+        inputs.add(id.raw()).add(ns->second.name);
+      } else {
+        const auto& c = index.records.entries.at(id);
+        inputs.add(id.raw()).add(c.type).add(c.name);
+      }
+    }
+  }
+}
+
+uint64_t hdoc::serde::HTMLWriter::getPageInputs(const hdoc::types::FunctionSymbol& f) const {
+  PageInputs inputs;
+  inputs.add(this->renderKey).add(f);
+  addBreadcrumbInputs(inputs, f, *this->index);
+  return inputs.hash();
+}
+
+uint64_t hdoc::serde::HTMLWriter::getPageInputs(const hdoc::types::RecordSymbol& c) const {
+  PageInputs inputs;
+  inputs.add(this->renderKey).add(c);
+  addBreadcrumbInputs(inputs, c, *this->index);
+  for (const auto& var : c.vars) {
+    inputs.add(var.type);
+  }
+
+  // Base records are linked by name if they're indexed
+  for (const auto& baseRecord : c.baseRecords) {
+    inputs.add(baseRecord.id.raw()).add(baseRecord.name);
+    if (this->index->records.contains(baseRecord.id)) {
+      inputs.add(this->index->records.entries.at(baseRecord.id).name);
+    }
+  }
+
+  // Methods are documented in full, in the same order as they're printed
+  for (const auto& id : getSortedIDs(c.methodIDs, this->index->functions)) {
+    inputs.add(this->index->functions.entries.at(id));
+  }
+
+  // Inherited variables and methods are listed with their names, access, and the record they come from
+  for (const auto& id : getInheritedRecordIDs(*this->index, c)) {
+    const auto& ic = this->index->records.entries.at(id);
+    inputs.add(id.raw()).add(ic.fingerprint);
+    for (const auto& methodID : getSortedIDs(ic.methodIDs, this->index->functions)) {
+      inputs.add(methodID.raw()).add(this->index->functions.entries.at(methodID).fingerprint);
+    }
+  }
+
+  // Records and functions that use this one are linked by name, with methods linking to their record's page
+  for (const auto& id : getSortedIDs(c.usedByRecordIDs, this->index->records)) {
+    const auto& r = this->index->records.entries.at(id);
+    inputs.add(id.raw()).add(r.type).add(r.name);
+  }
+  for (const auto& id : getSortedIDs(c.usedByFunctionIDs, this->index->functions)) {
+    const auto& f = this->index->functions.entries.at(id);
+    inputs.add(id.raw()).add(f.name).add(f.isRecordMember);
+    if (f.isRecordMember && this->index->records.contains(f.parentNamespaceID)) {
+      inputs.add(f.parentNamespaceID.raw()).add(this->index->records.entries.at(f.parentNamespaceID).name);
+    }
   }
-  printNewPage(*this->cfg, main, this->cfg->outputDir / "enums.html", "Enums: " + this->cfg->getPageTitleSuffix());
+  return inputs.hash();
+}
+
+uint64_t hdoc::serde::HTMLWriter::getPageInputs(const hdoc::types::EnumSymbol& e) const {
+  PageInputs inputs;
+  inputs.add(this->renderKey).add(e);
+  addBreadcrumbInputs(inputs, e, *this->index);
+  return inputs.hash();
+}
+
+/// Returns the symbols whose pages need to be printed, leaving out those for which isCurrent() returns true.
+/// Checking a page takes a stat(), so the symbols are checked in parallel on pool.
+template <typename T, typename F>
+static std::vector<const T*>
+getPagesToPrint(llvm::ThreadPool& pool, const std::vector<const T*>& symbols, F isCurrent) {
+  constexpr uint64_t     chunkSize = 1024;
+  std::vector<uint8_t>   current(symbols.size());
+  hdoc::utils::TaskGroup tasks(pool);
+  for (uint64_t i = 0; i < symbols.size(); i += chunkSize) {
+    tasks.async([&, i] {
+      for (uint64_t j = i; j < std::min(i + chunkSize, static_cast<uint64_t>(symbols.size())); j++) {
+        current[j] = isCurrent(*symbols[j]);
+      }
+    });
+  }
+  tasks.wait();
+
+  std::vector<const T*> toPrint;
+  for (uint64_t i = 0; i < symbols.size(); i++) {
+    if (current[i] == false) {
+      toPrint.push_back(symbols[i]);
+    }
+  }
+  return toPrint;
+}
+
+/// Add tasks that print pages for each of the symbols, batchSize symbols at a time.
+/// symbols must outlive the tasks.
+template <typename T, typename F>
+static void addPageBatches(std::vector<std::function<void()>>& tasks,
+                           const std::vector<const T*>&        symbols,
+                           const uint64_t                      batchSize,
+                           F                                   print) {
+  for (uint64_t i = 0; i < symbols.size(); i += batchSize) {
+    tasks.push_back([&symbols, i, batchSize, print] {
+      for (uint64_t j = i; j < std::min(i + batchSize, static_cast<uint64_t>(symbols.size())); j++) {
+        print(*symbols[j]);
+      }
+    });
+  }
+}
+
+void hdoc::serde::HTMLWriter::printAll() const {
+  // Overview pages are the most expensive to render, so they're queued first to start while the symbol pages run
+  std::vector<std::function<void()>> tasks = {
+      [this] { this->printFunctionsOverview(); },
+      [this] { this->printRecordsOverview(); },
+      [this] { this->printEnumsOverview(); },
+      [this] { this->printNamespaces(); },
+      [this] { this->printSearchPage(); },
+      [this] { this->printSearchIndex(); },
+      [this] { this->printProjectIndex(); },
+  };
+  for (auto& task : this->getMarkdownTasks()) {
+    tasks.push_back(std::move(task));
+  }
+  // The assets are written on every run, even though they never change, so that they're in the manifest
+  if (this->writesAssets) {
+    tasks.push_back([this] {
+      for (const auto& file : getBundledAssets(this->cfg->outputDir)) {
+        this->output.write(file.path, std::string(reinterpret_cast<const char*>(file.file), file.len));
+      }
+    });
+  }
+
+  std::vector<const hdoc::types::FunctionSymbol*> functions;
+  for (const auto& [k, f] : this->index->functions.entries) {
+    // Methods are printed on their record's page
+    if (f.isRecordMember == false) {
+      functions.push_back(&f);
+    }
+  }
+  std::vector<const hdoc::types::RecordSymbol*> records;
+  for (const auto& [k, c] : this->index->records.entries) {
+    records.push_back(&c);
+  }
+  std::vector<const hdoc::types::EnumSymbol*> enums;
+  for (const auto& [k, e] : this->index->enums.entries) {
+    enums.push_back(&e);
+  }
+
+  // Symbol pages are only printed again if something they're rendered from has changed since the previous run.
+  // Overview pages list every symbol, so they're always printed.
+  const uint64_t numSymbolPages = functions.size() + records.size() + enums.size();
+  const auto     isCurrent      = [this](const auto& s) {
+    return this->output.keepIfCurrent(this->cfg->outputDir / s.url(this->cfg->shardPages), this->getPageInputs(s));
+  };
+  functions = getPagesToPrint(this->pool, functions, isCurrent);
+  records   = getPagesToPrint(this->pool, records, isCurrent);
+  enums     = getPagesToPrint(this->pool, enums, isCurrent);
+  spdlog::info("Skipping {} of {} symbol pages whose inputs haven't changed since the previous run.",
+               numSymbolPages - functions.size() - records.size() - enums.size(),
+               numSymbolPages);
+
+  // Aim for enough batches that every thread has plenty of them, so threads that get expensive pages don't hold up
+  // the rest, while keeping each batch large enough that the overhead of a task is negligible
+  const uint64_t numPages   = tasks.size() + functions.size() + records.size() + enums.size();
+  const uint64_t numThreads = this->cfg->renderThreads != 0 ? this->cfg->renderThreads : this->pool.getThreadCount();
+  const uint64_t batchSize  = std::clamp<uint64_t>(numPages / (numThreads * 16), 1, 64);
+  addPageBatches(tasks, records, batchSize, [this](const auto& c) { this->printRecord(c); });
+  addPageBatches(tasks, functions, batchSize, [this](const auto& f) { this->printFunction(f); });
+  addPageBatches(tasks, enums, batchSize, [this](const auto& e) { this->printEnum(e); });
+  this->runRenderTasks(tasks, numPages);
+
+  // Every page has been written, so anything left over from the previous run belongs to a symbol that's gone
+  const uint64_t deletedBefore = this->output.stats().deleted;
+  this->output.removeStale();
+  this->output.saveManifest();
+  spdlog::info("Deleted {} files left over from the previous run.", this->output.stats().deleted - deletedBefore);
+}
+
+bool hdoc::serde::HTMLWriter::finishArchive() const {
+  return this->output.finishArchive();
+}
+
+void hdoc::serde::HTMLWriter::runRenderTasks(const std::vector<std::function<void()>>& tasks,
+                                             const uint64_t                            numPages) const {
+  std::optional<llvm::ThreadPool> renderPool;
+  if (this->cfg->renderThreads != 0) {
+    renderPool.emplace(llvm::hardware_concurrency(this->cfg->renderThreads));
+  }
+  llvm::ThreadPool& pool = renderPool ? *renderPool : this->pool;
+
+  // Each thread's time spent rendering, and when it finished its last task
+  struct WorkerStats {
+    std::chrono::steady_clock::duration   busy = {};
+    std::chrono::steady_clock::time_point lastEnd;
+  };
+  std::mutex                                       mutex;
+  std::unordered_map<std::thread::id, WorkerStats> workers;
+
+  const auto             outputBefore = this->output.stats();
+  const auto             start        = std::chrono::steady_clock::now();
+  hdoc::utils::TaskGroup group(pool);
+  for (const auto& task : tasks) {
+    group.async([&] {
+      const auto taskStart = std::chrono::steady_clock::now();
+      task();
+      const auto       taskEnd = std::chrono::steady_clock::now();
+      std::scoped_lock lock(mutex);
+      auto&            worker = workers[std::this_thread::get_id()];
+      worker.busy += taskEnd - taskStart;
+      worker.lastEnd = taskEnd;
+    });
+  }
+  group.wait();
+  const auto end = std::chrono::steady_clock::now();
+
+  // Idle time is split into time that threads spent waiting while there were still tasks to run, and time they
+  // spent with nothing left to do while the last tasks finished. Threads that never ran a task count as the latter.
+  const uint64_t                      numThreads = pool.getThreadCount();
+  const auto                          elapsed    = end - start;
+  std::chrono::steady_clock::duration busy       = {};
+  std::chrono::steady_clock::duration drain      = elapsed * (numThreads - std::min(workers.size(), numThreads));
+  for (const auto& [id, worker] : workers) {
+    busy += worker.busy;
+    drain += end - worker.lastEnd;
+  }
+  const auto queued = elapsed * numThreads - busy - drain;
+
+  const auto ms = [](const std::chrono::steady_clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+  };
+  spdlog::info("Rendered {} pages in {} ms ({:.0f} pages/s) using {} threads.",
+               numPages,
+               ms(elapsed),
+               numPages / std::max(std::chrono::duration<double>(elapsed).count(), 1e-9),
+               numThreads);
+  spdlog::info("Render threads were idle for {} ms while pages were queued and {} ms while the last pages finished.",
+               ms(queued),
+               ms(drain));
+
+  // Pages are still being written in the background, so wait for them before reporting how the output stage did
+  this->output.flush();
+  const auto written      = std::chrono::steady_clock::now() - start;
+  const auto outputAfter  = this->output.stats();
+  const auto bytesWritten = outputAfter.bytes - outputBefore.bytes;
+  spdlog::info("Wrote {} files and left {} unchanged files untouched.",
+               outputAfter.files - outputBefore.files,
+               outputAfter.unchanged - outputBefore.unchanged);
+  spdlog::info("Wrote {} bytes ({:.1f} MB/s) with up to {} files queued, {} ms after rendering finished.",
+               bytesWritten,
+               bytesWritten / 1e6 / std::max(std::chrono::duration<double>(written).count(), 1e-9),
+               outputAfter.maxQueueDepth,
+               ms(std::chrono::steady_clock::now() - end));
+  spdlog::info("Render threads waited {} ms for room in the output queue.",
+               ms(outputAfter.blockedTime - outputBefore.blockedTime));
 }
 
 void hdoc::serde::HTMLWriter::printSearchPage() const {
@@ -995,14 +1492,23 @@ We have left the Javascript code unminified so that you are able to inspect it y
   main.AddChild(input);
   main.AddChild(CTML::Node("div#loader").AddChild(CTML::Node("span.loader")));
   main.AddChild(CTML::Node("p#info", "Loading index of all symbols. This may take time for large codebases."));
-  main.AddChild(CTML::Node("div.panel is-hoverable#results").SetAttr("style", "display: none"));
+  // search.js needs to know whether pages are sharded to link to them
+  main.AddChild(CTML::Node("div.panel is-hoverable#results")
+                    .SetAttr("style", "display: none")
+                    .SetAttr("data-sharded", this->cfg->shardPages ? "true" : "false"));
   main.AddChild(CTML::Node("script").SetAttr("src", "index.min.js"));
   main.AddChild(CTML::Node("script").SetAttr("src", "search.js"));
-  printNewPage(*this->cfg, main, this->cfg->outputDir / "search.html", "Search: " + this->cfg->getPageTitleSuffix());
+  printNewPage(this->output,
+               this->shell,
+               main,
+               this->cfg->outputDir / "search.html",
+               "Search: " + this->cfg->getPageTitleSuffix());
+}
 
-  std::error_code      ec;
-  llvm::raw_fd_ostream jsonPath((cfg->outputDir / "index.json").string(), ec);
-  llvm::json::OStream  json(jsonPath);
+void hdoc::serde::HTMLWriter::printSearchIndex() const {
+  std::string              jsonBuffer = this->output.acquireBuffer();
+  llvm::raw_string_ostream jsonStream(jsonBuffer);
+  llvm::json::OStream      json(jsonStream);
 
   json.array([&] {
     for (const auto& s : this->index->functions.entries)
@@ -1050,39 +1556,144 @@ We have left the Javascript code unminified so that you are able to inspect it y
       }
     }
   });
+  jsonStream.flush();
+  this->output.write(this->cfg->outputDir / "index.json", std::move(jsonBuffer));
+}
+
+/// Returns the contents of the Markdown page at path, from the Config if it's kept in memory and from disk otherwise.
+/// If it's read from disk, file owns the contents. Returns std::nullopt if it couldn't be read.
+static std::optional<std::string_view> getMarkdown(const hdoc::types::Config&           cfg,
+                                                   const std::filesystem::path&         path,
+                                                   std::unique_ptr<llvm::MemoryBuffer>& file) {
+  if (const auto it = cfg.mdContents.find(path.string()); it != cfg.mdContents.end()) {
+    return it->second;
+  }
+  auto buffer = llvm::MemoryBuffer::getFile(path.string(), /*IsText=*/true);
+  if (!buffer) {
+    spdlog::warn("Unable to read Markdown file {}: {}. Its page will say that it couldn't be read.",
+                 path.string(),
+                 buffer.getError().message());
+    return std::nullopt;
+  }
+  file = std::move(buffer.get());
+  return file->getBuffer();
+}
+
+/// Print the Markdown page at path to outputPath, with the converted HTML appended straight to the page.
+/// If the Markdown can't be read, the page is still printed with a note saying so, since the sidebar links to it.
+static void printMarkdownPage(hdoc::serde::OutputWriter&    output,
+                              const hdoc::serde::PageShell& shell,
+                              const hdoc::types::Config&    cfg,
+                              const std::filesystem::path&  path,
+                              const std::filesystem::path&  outputPath,
+                              const std::string_view        pageTitle) {
+  std::string&             buffer = getPageBuffer();
+  hdoc::serde::HTMLEmitter html(buffer);
+  startPage(html, shell, pageTitle);
+
+  std::unique_ptr<llvm::MemoryBuffer> file;
+  if (const auto markdown = getMarkdown(cfg, path, file)) {
+    const hdoc::utils::MarkdownConverter converter(*markdown, path.string());
+    html.open("main.content").raw(converter.getHTML()).close();
+  } else {
+    html.open("main.content")
+        .element("h1", pageTitle)
+        .element("p", "This page couldn't be read when the documentation was generated.")
+        .close();
+  }
+  finishPage(html, shell, buffer, output, outputPath);
 }
 
 /// Print the homepage of the documentation
 void hdoc::serde::HTMLWriter::printProjectIndex() const {
-  CTML::Node main("main");
+  const std::filesystem::path path = this->cfg->outputDir / "index.html";
 
   // If index markdown page was supplied, convert it to markdown and print it
   if (this->cfg->homepage != "") {
-    hdoc::utils::MarkdownConverter converter(this->cfg->homepage);
-    main = converter.getHTMLNode();
+    printMarkdownPage(
+        this->output, this->shell, *this->cfg, this->cfg->homepage, path, this->cfg->getPageTitleSuffix());
+    return;
   }
+
   // Otherwise, create a simple page with links to the documentation
-  else {
-    main.AddChild(CTML::Node("h1", this->cfg->getPageTitleSuffix()));
-    CTML::Node ul("ul");
+  std::string& buffer = getPageBuffer();
+  HTMLEmitter  html(buffer);
+  startPage(html, this->shell, this->cfg->getPageTitleSuffix());
+  html.open("main.content").element("h1", this->cfg->getPageTitleSuffix()).open("ul");
+  html.open("li").open("a").attr("href", "records.html").text("Records").close().close();
+  html.open("li").open("a").attr("href", "functions.html").text("Functions").close().close();
+  html.open("li").open("a").attr("href", "enums.html").text("Enums").close().close();
+  html.open("li").open("a").attr("href", "namespaces.html").text("Namespaces").close().close();
+  html.close().close();
+  finishPage(html, this->shell, buffer, this->output, path);
+}
 
-    ul.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Records").SetAttr("href", "records.html")));
-    ul.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Functions").SetAttr("href", "functions.html")));
-    ul.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Enums").SetAttr("href", "enums.html")));
-    ul.AddChild(CTML::Node("li").AddChild(CTML::Node("a", "Namespaces").SetAttr("href", "namespaces.html")));
-    main.AddChild(ul);
+std::vector<std::function<void()>> hdoc::serde::HTMLWriter::getMarkdownTasks() const {
+  std::vector<std::function<void()>> tasks;
+  for (const auto& f : this->cfg->mdPaths) {
+    tasks.push_back([this, &f] {
+      const std::filesystem::path path = this->cfg->outputDir / getMarkdownPageURL(f);
+      printMarkdownPage(this->output, this->shell, *this->cfg, f, path, getMarkdownPageTitle(f));
+    });
   }
-
-  printNewPage(*this->cfg, main, this->cfg->outputDir / "index.html", this->cfg->getPageTitleSuffix());
+  return tasks;
 }
 
 void hdoc::serde::HTMLWriter::processMarkdownFiles() const {
-  for (const auto& f : this->cfg->mdPaths) {
-    spdlog::info("Processing markdown file {}", f.string());
-    hdoc::utils::MarkdownConverter converter(f);
-    CTML::Node                     main      = converter.getHTMLNode();
-    std::string                    filename  = "doc" + f.filename().replace_extension("html").string();
-    std::string                    pageTitle = f.filename().stem().string();
-    printNewPage(*this->cfg, main, this->cfg->outputDir / filename, pageTitle);
+  const auto tasks = this->getMarkdownTasks();
+  this->runRenderTasks(tasks, tasks.size());
+}
+
+/// Returns the kind and ID of the symbol whose page is at url, or std::nullopt if url isn't a symbol's page
+static std::optional<std::pair<char, hdoc::types::SymbolID>> parseSymbolPageURL(const std::string_view url,
+                                                                                const bool             sharded) {
+  // A page's URL is its kind, its ID in hex, and ".html", inside its shard's subdirectory if pages are sharded
+  const std::string_view filename = sharded ? url.substr(std::min<uint64_t>(url.size(), 3)) : url;
+  if (filename.size() != 1 + 16 + 5 || filename.ends_with(".html") == false) {
+    return std::nullopt;
+  }
+  hdoc::types::SymbolID id;
+  if (llvm::StringRef(filename.data() + 1, 16).getAsInteger(16, id.hashValue) ||
+      hdoc::types::pageURL(filename[0], id, sharded) != url) {
+    return std::nullopt;
+  }
+  return std::make_pair(filename[0], id);
+}
+
+std::optional<std::string> hdoc::serde::HTMLWriter::renderPage(const std::string_view url) const {
+  if (url == "index.html") {
+    this->printProjectIndex();
+  } else if (url == "functions.html") {
+    this->printFunctionsOverview();
+  } else if (url == "records.html") {
+    this->printRecordsOverview();
+  } else if (url == "enums.html") {
+    this->printEnumsOverview();
+  } else if (url == "namespaces.html") {
+    this->printNamespaces();
+  } else if (url == "search.html") {
+    this->printSearchPage();
+  } else if (url == "index.json") {
+    this->printSearchIndex();
+  } else if (const auto symbol = parseSymbolPageURL(url, this->cfg->shardPages)) {
+    // Methods and namespaces don't have pages of their own
+    const auto& [kind, id] = *symbol;
+    if (kind == 'f' && this->index->functions.contains(id) &&
+        this->index->functions.entries.at(id).isRecordMember == false) {
+      this->printFunction(this->index->functions.entries.at(id));
+    } else if (kind == 'r' && this->index->records.contains(id)) {
+      this->printRecord(this->index->records.entries.at(id));
+    } else if (kind == 'e' && this->index->enums.contains(id)) {
+      this->printEnum(this->index->enums.entries.at(id));
+    }
+  } else {
+    for (const auto& f : this->cfg->mdPaths) {
+      if (getMarkdownPageURL(f) == url) {
+        const std::filesystem::path path = this->cfg->outputDir / url;
+        printMarkdownPage(this->output, this->shell, *this->cfg, f, path, getMarkdownPageTitle(f));
+        break;
+      }
+    }
   }
+  return this->output.take(this->cfg->outputDir / url);
 }
@@ -5,38 +5,113 @@
 
 #include "llvm/Support/ThreadPool.h"
 
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "serde/OutputWriter.hpp"
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
 namespace hdoc {
 namespace serde {
 
+/// @brief The HTML that's the same for every page, i.e. the head, sidebar, and footer.
+/// A page is the prefix, followed by its title, the middle, its content, and finally the suffix.
+struct PageShell {
+  std::string prefix; ///< Everything before the page's <title> element
+  std::string middle; ///< Everything between the title and the page's content
+  std::string suffix; ///< Everything after the page's content
+};
+
 /// @brief Serialize hdoc's index to HTML files
 class HTMLWriter {
 public:
-  HTMLWriter(const hdoc::types::Index* index, const hdoc::types::Config* cfg, llvm::ThreadPool& pool);
-  void printFunctions() const;
-  void printRecords() const;
+  /// @brief Create a writer, and prepare the output directory or archive for it.
+  /// The bundled assets (CSS, JS, favicons) are written by printAll(), unless sharedAssetsDir is given, in which case
+  /// they're linked from there instead.
+  HTMLWriter(const hdoc::types::Index*    index,
+             const hdoc::types::Config*   cfg,
+             llvm::ThreadPool&            pool,
+             const std::filesystem::path& sharedAssetsDir = {});
+
+  /// @brief Write the assets bundled with hdoc to dir
+  static void writeBundledAssets(const std::filesystem::path& dir);
+
+  /// @brief Returns the contents of the bundled asset with the given filename, or std::nullopt if there's no such asset
+  static std::optional<std::string_view> getBundledAsset(const std::string_view name);
+
+  /// @brief Render the page at url, relative to the output directory, and return it instead of writing it.
+  /// Returns std::nullopt if there's no page at url. Only used by the preview server, where the Config's servePort is
+  /// set so that pages are kept in memory. Different pages can be rendered at the same time, but a page must not be
+  /// rendered by two threads at once.
+  std::optional<std::string> renderPage(const std::string_view url) const;
+
+  /// @brief Print every page of the documentation.
+  /// All of the pages are enumerated up front and rendered as one set of tasks, without waiting for one type of
+  /// page to finish before starting the next. Small pages are batched together into a single task.
+  /// It can be called again after the Index changes, e.g. in watch mode, to print only the pages whose inputs have
+  /// changed and delete those of symbols that were removed.
+  void printAll() const;
+
+  /// @brief Finish the output archive, if the documentation is written to one, once every page has been printed.
+  /// Returns false if any part of the archive couldn't be written.
+  bool finishArchive() const;
+
+  void printFunction(const hdoc::types::FunctionSymbol& f) const;
+  void printFunctionsOverview() const;
   void printRecord(const hdoc::types::RecordSymbol& c) const;
+  void printRecordsOverview() const;
   void printNamespaces() const;
-  void printEnums() const;
   void printEnum(const hdoc::types::EnumSymbol& e) const;
+  void printEnumsOverview() const;
 
   /// @brief Print the search page for the documentation
   void printSearchPage() const;
 
+  /// @brief Print index.json, the list of symbols that the search page searches through
+  void printSearchIndex() const;
+
   /// @brief Print the index.html page for the documentation
   void printProjectIndex() const;
 
-  /// @brief Convert Markdown files to HTML and save them to the filesystem
+  /// @brief Convert Markdown files to HTML and save them to the filesystem, in parallel.
+  /// Pages whose contents were deserialized from an archive are read from memory instead of from disk.
   void processMarkdownFiles() const;
 
 private:
+  /// @brief Run the tasks, which render numPages pages between them, wait for the pages to be written, and report
+  /// how long it took. They run on a dedicated pool if render_threads is set, and on the pool shared with the indexer
+  /// otherwise.
+  void runRenderTasks(const std::vector<std::function<void()>>& tasks, const uint64_t numPages) const;
+
+  /// @brief Returns one task per Markdown page. Each thread converts Markdown with its own parser, so the tasks can
+  /// all run at the same time.
+  std::vector<std::function<void()>> getMarkdownTasks() const;
+
+  /// @brief Returns a hash of everything a symbol's page is rendered from: the symbol itself, and whatever else is
+  /// printed on its page, like its breadcrumbs, methods, inherited members, and the names of the records it links to.
+  /// Pages whose inputs are the same as in the previous run aren't printed again. The symbols themselves are
+  /// represented by their fingerprints, so hdoc::utils::computeFingerprints() must have been run on the Index.
+  uint64_t getPageInputs(const hdoc::types::FunctionSymbol& f) const;
+  uint64_t getPageInputs(const hdoc::types::RecordSymbol& c) const;
+  uint64_t getPageInputs(const hdoc::types::EnumSymbol& e) const;
+
   const hdoc::types::Index*  index;
   const hdoc::types::Config* cfg;
   llvm::ThreadPool&          pool;
+  const PageShell            shell;     ///< Rendered once, and then shared by every page
+  const uint64_t             renderKey;            ///< Hash of the shell and settings, which are inputs of every page
+  bool                       writesAssets = false; ///< Are the bundled assets written by printAll()?
+  mutable OutputWriter       output;               ///< Writes pages in the background once they're rendered
 };
-std::string getHyperlinkedFunctionProto(const std::string_view proto, const hdoc::types::FunctionSymbol& f);
+std::string getHyperlinkedFunctionProto(const std::string_view             proto,
+                                        const hdoc::types::FunctionSymbol& f,
+                                        const bool                         sharded = false);
+std::string getHyperlinkedTypeName(const hdoc::types::TypeRef& type, const bool sharded = false);
 std::string clangFormat(const std::string_view s, const uint64_t& columnLimit = 50);
 std::string getBareTypeName(const std::string_view typeName);
 } // namespace serde
@@ -0,0 +1,431 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/OutputWriter.hpp"
+
+#include "spdlog/spdlog.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/xxhash.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Maximum number of files a writer thread takes off the queue at once
+static constexpr uint64_t batchSize = 32;
+
+/// Name of the manifest file, and the first line of its contents.
+/// Each following line is the hash, size, and inputs hash of a file, followed by its path relative to the manifest's
+/// directory.
+static constexpr char manifestName[]   = ".hdoc-manifest";
+static constexpr char manifestHeader[] = "hdoc-manifest 2";
+
+hdoc::serde::OutputWriter::OutputWriter(const uint32_t numThreads, const uint64_t maxQueueDepth)
+    : maxQueueDepth(std::max<uint64_t>(maxQueueDepth, 1)) {
+  for (uint32_t i = 0; i < std::max<uint32_t>(numThreads, 1); i++) {
+    this->threads.emplace_back([this] { this->run(); });
+  }
+}
+
+hdoc::serde::OutputWriter::~OutputWriter() {
+  {
+    std::scoped_lock lock(this->mutex);
+    this->stopping = true;
+  }
+  this->queued.notify_all();
+  for (auto& t : this->threads) {
+    t.join();
+  }
+  this->saveManifest();
+  if (this->archive) {
+    this->archive->finish();
+  }
+}
+
+std::string hdoc::serde::OutputWriter::acquireBuffer() {
+  std::scoped_lock lock(this->mutex);
+  if (this->freeBuffers.empty()) {
+    return std::string();
+  }
+  std::string buffer = std::move(this->freeBuffers.back());
+  this->freeBuffers.pop_back();
+  return buffer;
+}
+
+void hdoc::serde::OutputWriter::write(std::filesystem::path path, std::string contents, const uint64_t inputs) {
+  std::unique_lock lock(this->mutex);
+  if (this->inMemory) {
+    this->counters.files++;
+    this->counters.bytes += contents.size();
+    this->memoryFiles[path.string()] = std::move(contents);
+    return;
+  }
+  if (this->queue.size() >= this->maxQueueDepth) {
+    const auto start = std::chrono::steady_clock::now();
+    this->written.wait(lock, [this] { return this->queue.size() < this->maxQueueDepth; });
+    this->counters.blockedTime += std::chrono::steady_clock::now() - start;
+  }
+  this->queue.push_back({std::move(path), std::move(contents), inputs});
+  this->counters.maxQueueDepth = std::max<uint64_t>(this->counters.maxQueueDepth, this->queue.size());
+  lock.unlock();
+  this->queued.notify_one();
+}
+
+void hdoc::serde::OutputWriter::flush() {
+  std::unique_lock lock(this->mutex);
+  this->written.wait(lock, [this] { return this->queue.empty() && this->inFlight == 0; });
+}
+
+hdoc::serde::OutputWriter::Stats hdoc::serde::OutputWriter::stats() {
+  std::scoped_lock lock(this->mutex);
+  return this->counters;
+}
+
+/// Write contents to path with a single open(), write(), and close() where possible.
+/// Returns false and logs an error if the file couldn't be written.
+static bool writeFile(const std::filesystem::path& path, const std::string& contents) {
+  const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    spdlog::error("Unable to open {} for writing: {}", path.string(), std::strerror(errno));
+    return false;
+  }
+  uint64_t written = 0;
+  while (written < contents.size()) {
+    const ssize_t n = ::write(fd, contents.data() + written, contents.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      spdlog::error("Unable to write to {}: {}", path.string(), std::strerror(errno));
+      close(fd);
+      return false;
+    }
+    written += n;
+  }
+  return close(fd) == 0;
+}
+
+void hdoc::serde::OutputWriter::useManifest(const std::filesystem::path& root) {
+  std::scoped_lock lock(this->mutex);
+  this->manifestRoot = root;
+  this->manifest.clear();
+
+  // A missing or unreadable manifest only means that every file is written again
+  auto buffer = llvm::MemoryBuffer::getFile((root / manifestName).string(), /*IsText=*/true);
+  if (!buffer) {
+    return;
+  }
+  llvm::StringRef contents = buffer.get()->getBuffer();
+  llvm::StringRef line;
+  std::tie(line, contents) = contents.split('\n');
+  if (line != manifestHeader) {
+    spdlog::warn("Ignoring manifest {} with an unknown format.", (root / manifestName).string());
+    return;
+  }
+  while (contents.empty() == false) {
+    std::tie(line, contents) = contents.split('\n');
+    llvm::StringRef hash, size, inputs, path;
+    std::tie(hash, line)   = line.split(' ');
+    std::tie(size, line)   = line.split(' ');
+    std::tie(inputs, path) = line.split(' ');
+    ManifestEntry entry;
+    if (hash.getAsInteger(16, entry.hash) || size.getAsInteger(10, entry.size) ||
+        inputs.getAsInteger(16, entry.inputs) || path.empty()) {
+      continue;
+    }
+    this->manifest[path.str()] = entry;
+  }
+
+  // The manifest is only valid until files start being written again, so it's removed until it's saved. Otherwise, a
+  // run that was interrupted would leave behind a manifest that doesn't match the files in root.
+  std::error_code ec;
+  std::filesystem::remove(root / manifestName, ec);
+}
+
+std::string hdoc::serde::OutputWriter::getManifestKey(const std::filesystem::path& path) const {
+  if (this->manifestRoot.empty()) {
+    return "";
+  }
+  const std::string key = path.lexically_relative(this->manifestRoot).generic_string();
+  if (key.empty() || key.starts_with("..")) {
+    return "";
+  }
+  return key;
+}
+
+bool hdoc::serde::OutputWriter::keepIfCurrent(const std::filesystem::path& path, const uint64_t inputs) {
+  const std::string key = this->getManifestKey(path);
+  if (key == "" || inputs == 0) {
+    return false;
+  }
+
+  uint64_t size = 0;
+  {
+    std::scoped_lock lock(this->mutex);
+    const auto       it = this->manifest.find(key);
+    if (it == this->manifest.end() || it->second.inputs != inputs) {
+      return false;
+    }
+    size = it->second.size;
+  }
+
+  // The file is only kept if it hasn't been deleted or modified since it was written
+  std::error_code ec;
+  if (std::filesystem::file_size(path, ec) != size || ec) {
+    return false;
+  }
+  std::scoped_lock lock(this->mutex);
+  if (const auto it = this->manifest.find(key); it != this->manifest.end()) {
+    it->second.current = true;
+  }
+  return true;
+}
+
+void hdoc::serde::OutputWriter::remove(const std::filesystem::path& path) {
+  std::error_code ec;
+  const bool      removed = std::filesystem::remove(path, ec);
+
+  std::scoped_lock lock(this->mutex);
+  if (const std::string key = this->getManifestKey(path); key != "") {
+    this->manifest.erase(key);
+  }
+  this->counters.deleted += removed;
+}
+
+void hdoc::serde::OutputWriter::removeStale() {
+  std::vector<std::filesystem::path> stale;
+  {
+    std::scoped_lock lock(this->mutex);
+    for (auto it = this->manifest.begin(); it != this->manifest.end();) {
+      if (it->second.current) {
+        it->second.current = false;
+        ++it;
+        continue;
+      }
+      stale.push_back(this->manifestRoot / it->first);
+      it = this->manifest.erase(it);
+    }
+  }
+
+  uint64_t deleted = 0;
+  for (const auto& path : stale) {
+    std::error_code ec;
+    deleted += std::filesystem::remove(path, ec);
+  }
+  std::scoped_lock lock(this->mutex);
+  this->counters.deleted += deleted;
+}
+
+void hdoc::serde::OutputWriter::saveManifest() {
+  std::scoped_lock lock(this->mutex);
+  if (this->manifestRoot.empty()) {
+    return;
+  }
+
+  // Written to a temporary file first, so that an interrupted run can't leave a truncated manifest behind
+  const std::filesystem::path path    = this->manifestRoot / manifestName;
+  const std::filesystem::path tmpPath = this->manifestRoot / (std::string(manifestName) + ".tmp");
+  std::FILE*                  out     = std::fopen(tmpPath.c_str(), "w");
+  if (out == nullptr) {
+    spdlog::error("Unable to save manifest to {}: {}", tmpPath.string(), std::strerror(errno));
+    return;
+  }
+  std::fprintf(out, "%s\n", manifestHeader);
+  for (const auto& [key, entry] : this->manifest) {
+    std::fprintf(
+        out, "%016" PRIX64 " %" PRIu64 " %016" PRIX64 " %s\n", entry.hash, entry.size, entry.inputs, key.c_str());
+  }
+  if (std::fclose(out) != 0) {
+    spdlog::error("Unable to save manifest to {}: {}", tmpPath.string(), std::strerror(errno));
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    spdlog::error("Unable to save manifest to {}: {}", path.string(), ec.message());
+  }
+}
+
+bool hdoc::serde::OutputWriter::useArchive(const std::filesystem::path& archivePath,
+                                           const std::filesystem::path& root) {
+  std::string err;
+  auto        archive = TarWriter::open(archivePath, err);
+  if (archive == nullptr) {
+    spdlog::error("Unable to open output archive {}: {}", archivePath.string(), err);
+    return false;
+  }
+  std::scoped_lock lock(this->mutex, this->archiveMutex);
+  this->archive     = std::move(archive);
+  this->archiveRoot = root;
+  return true;
+}
+
+bool hdoc::serde::OutputWriter::finishArchive() {
+  this->flush();
+  std::scoped_lock lock(this->archiveMutex);
+  if (this->archive == nullptr) {
+    return true;
+  }
+  const bool finished = this->archive->finish();
+  return finished && this->archiveFailed == false;
+}
+
+void hdoc::serde::OutputWriter::keepInMemory() {
+  std::scoped_lock lock(this->mutex);
+  this->inMemory = true;
+}
+
+std::optional<std::string> hdoc::serde::OutputWriter::take(const std::filesystem::path& path) {
+  std::scoped_lock lock(this->mutex);
+  const auto       it = this->memoryFiles.find(path.string());
+  if (it == this->memoryFiles.end()) {
+    return std::nullopt;
+  }
+  std::string contents = std::move(it->second);
+  this->memoryFiles.erase(it);
+  return contents;
+}
+
+void hdoc::serde::OutputWriter::addToArchive(const std::vector<File>& batch,
+                                             const uint64_t           batchNumber,
+                                             uint64_t&                files,
+                                             uint64_t&                bytes) {
+  // Batches are added in the order they were taken off the queue, so the archive's order is the order of write() calls
+  std::unique_lock lock(this->archiveMutex);
+  this->archiveTurn.wait(lock, [&] { return this->batchesAdded == batchNumber; });
+  for (const auto& file : batch) {
+    const std::string name = file.path.lexically_relative(this->archiveRoot).generic_string();
+    if (name.empty() || name.starts_with("..")) {
+      spdlog::error("Unable to add {} to the output archive since it's outside of {}.",
+                    file.path.string(),
+                    this->archiveRoot.string());
+      continue;
+    }
+    // Once adding a file fails the archive is unusable, so the error is only reported once
+    if (this->archive->add(name, file.contents) == false) {
+      if (this->archiveFailed == false) {
+        spdlog::error("Unable to add {} to the output archive: {}", name, std::strerror(errno));
+        this->archiveFailed = true;
+      }
+      continue;
+    }
+    files++;
+    bytes += file.contents.size();
+  }
+  this->batchesAdded++;
+  lock.unlock();
+  this->archiveTurn.notify_all();
+}
+
+void hdoc::serde::OutputWriter::run() {
+  /// A file's key in the manifest, the hash of its contents, and what happened when it was written
+  struct Status {
+    std::string key;
+    uint64_t    hash      = 0;
+    bool        unchanged = false;
+    bool        failed    = false;
+  };
+
+  std::vector<File>   batch;
+  std::vector<Status> statuses;
+  while (true) {
+    uint64_t batchNumber = 0;
+    bool     toArchive   = false;
+    {
+      std::unique_lock lock(this->mutex);
+      this->queued.wait(lock, [this] { return this->stopping || !this->queue.empty(); });
+      if (this->queue.empty()) {
+        return;
+      }
+      // Take several files at once so that the lock isn't contended once per file
+      const uint64_t n = std::min<uint64_t>(this->queue.size(), batchSize);
+      for (uint64_t i = 0; i < n; i++) {
+        batch.push_back(std::move(this->queue.front()));
+        this->queue.pop_front();
+      }
+      this->inFlight += n;
+      batchNumber = this->batchesTaken++;
+      toArchive   = this->archive != nullptr;
+    }
+    this->written.notify_all();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // Files in an archive don't touch the filesystem, and aren't in a manifest
+    uint64_t files = 0;
+    uint64_t bytes = 0;
+    if (toArchive) {
+      this->addToArchive(batch, batchNumber, files, bytes);
+    } else {
+      // Files that are in the manifest with the same hash and size might not need to be written
+      for (const auto& file : batch) {
+        Status status;
+        status.key  = this->getManifestKey(file.path);
+        status.hash = status.key != "" ? llvm::xxHash64(file.contents) : 0;
+        statuses.push_back(std::move(status));
+      }
+      {
+        std::scoped_lock lock(this->mutex);
+        for (uint64_t i = 0; i < batch.size(); i++) {
+          if (const auto it = this->manifest.find(statuses[i].key); it != this->manifest.end()) {
+            statuses[i].unchanged = it->second.hash == statuses[i].hash && it->second.size == batch[i].contents.size();
+          }
+        }
+      }
+
+      for (uint64_t i = 0; i < batch.size(); i++) {
+        // Unchanged files are only skipped if they haven't been deleted or modified since they were written
+        if (statuses[i].unchanged) {
+          std::error_code ec;
+          if (std::filesystem::file_size(batch[i].path, ec) == batch[i].contents.size() && !ec) {
+            continue;
+          }
+          statuses[i].unchanged = false;
+        }
+        if (writeFile(batch[i].path, batch[i].contents) == false) {
+          statuses[i].failed = true;
+          continue;
+        }
+        files++;
+        bytes += batch[i].contents.size();
+      }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    {
+      std::scoped_lock lock(this->mutex);
+      for (uint64_t i = 0; i < statuses.size(); i++) {
+        const Status& status = statuses[i];
+        if (status.key == "") {
+          continue;
+        }
+        // Files that couldn't be written are forgotten, so that they aren't assumed to be unchanged next time
+        if (status.failed) {
+          this->manifest.erase(status.key);
+        } else {
+          this->manifest[status.key] = {status.hash, batch[i].contents.size(), batch[i].inputs, true};
+        }
+        this->counters.unchanged += status.unchanged;
+      }
+      this->inFlight -= batch.size();
+      this->counters.files += files;
+      this->counters.bytes += bytes;
+      this->counters.writeTime += end - start;
+      // Keep enough buffers for a full queue, anything more would only be needed if rendering outpaced writing
+      for (auto& file : batch) {
+        if (this->freeBuffers.size() >= this->maxQueueDepth) {
+          break;
+        }
+        file.contents.clear();
+        this->freeBuffers.push_back(std::move(file.contents));
+      }
+    }
+    batch.clear();
+    statuses.clear();
+    this->written.notify_all();
+  }
+}
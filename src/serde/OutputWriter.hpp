@@ -0,0 +1,159 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "serde/TarWriter.hpp"
+
+namespace hdoc::serde {
+/// @brief Writes files in the background, so that the threads rendering pages don't wait on the filesystem.
+///
+/// Files are added to a bounded queue, which a few dedicated threads drain in batches. If the queue is full,
+/// write() blocks until there's room, which keeps memory use in check when the disk can't keep up. The buffers of
+/// files that have been written are kept and handed out again by acquireBuffer(), so that pages rarely need to
+/// allocate.
+///
+/// If a manifest is used, files whose contents are the same as when they were last written are left untouched, so
+/// that their modification times don't change and tools that sync the output elsewhere only copy what changed.
+/// Files can also be written along with a hash of the inputs they were generated from, so that the next run can check
+/// with keepIfCurrent() whether they need to be generated at all.
+///
+/// Instead of being written to the filesystem, files can also be streamed into a single tar archive in the order
+/// they're queued, or kept in memory until they're taken with take().
+class OutputWriter {
+public:
+  /// @brief Statistics about the files written since the OutputWriter was created
+  struct Stats {
+    uint64_t                 files         = 0;  ///< Number of files written
+    uint64_t                 unchanged     = 0;  ///< Number of files left untouched because they didn't change
+    uint64_t                 deleted       = 0;  ///< Number of files deleted by remove() or removeStale()
+    uint64_t                 bytes         = 0;  ///< Total size of the files written
+    uint64_t                 maxQueueDepth = 0;  ///< Largest number of files that were waiting to be written
+    std::chrono::nanoseconds writeTime     = {}; ///< Time spent writing, summed over all writer threads
+    std::chrono::nanoseconds blockedTime   = {}; ///< Time callers of write() spent waiting for a full queue
+  };
+
+  /// @brief Start numThreads writer threads. At most maxQueueDepth files wait to be written at once.
+  explicit OutputWriter(const uint32_t numThreads = 4, const uint64_t maxQueueDepth = 1024);
+
+  /// @brief Write any files still in the queue, stop the writer threads, and save the manifest if there is one
+  ~OutputWriter();
+  OutputWriter(const OutputWriter&)            = delete;
+  OutputWriter& operator=(const OutputWriter&) = delete;
+
+  /// @brief Returns an empty buffer, reusing the memory of a file that has already been written if possible
+  std::string acquireBuffer();
+
+  /// @brief Queue contents to be written to path, replacing the file if it exists.
+  /// If inputs isn't zero, it's recorded in the manifest as the hash of what the file was generated from.
+  void write(std::filesystem::path path, std::string contents, const uint64_t inputs = 0);
+
+  /// @brief Block until every file queued so far has been written
+  void flush();
+
+  /// @brief Returns statistics about the files written so far
+  Stats stats();
+
+  /// @brief Keep a manifest of the files written under root, in root/.hdoc-manifest.
+  /// The manifest from a previous run is loaded, and files whose new contents have the same hash and size as the
+  /// manifest records for them are left untouched if they still exist.
+  void useManifest(const std::filesystem::path& root);
+
+  /// @brief Returns true if path was generated from the same inputs by the previous run and still exists, in which case
+  /// it's kept as it is and doesn't need to be written again.
+  bool keepIfCurrent(const std::filesystem::path& path, const uint64_t inputs);
+
+  /// @brief Delete a file, and remove it from the manifest
+  void remove(const std::filesystem::path& path);
+
+  /// @brief Delete every file in the manifest that hasn't been written since the manifest was loaded.
+  /// After all of a run's files have been written, these are the files a previous run wrote that are no longer part
+  /// of the output, e.g. the pages of symbols that were removed. Must only be called once the queue is flushed.
+  /// The files that are kept are then no longer considered written, so that the next run with the same OutputWriter
+  /// (e.g. in watch mode) has to write or keep them again.
+  void removeStale();
+
+  /// @brief Save the manifest, if there is one
+  void saveManifest();
+
+  /// @brief Write every file into the tar archive at archivePath instead of the filesystem, named by its path
+  /// relative to root. "-" streams the archive to stdout, and it's compressed if archivePath ends in ".gz" or ".tgz".
+  /// Must be called before any files are written. Returns false if the archive can't be opened.
+  bool useArchive(const std::filesystem::path& archivePath, const std::filesystem::path& root);
+
+  /// @brief Write every file still in the queue, then the end of the archive, and close it. No files can be written
+  /// afterwards. Returns false if any file or the end of the archive couldn't be written, in which case the archive is
+  /// incomplete. Does nothing and returns true if there's no archive.
+  bool finishArchive();
+
+  /// @brief Keep files in memory instead of writing them, so that they can be retrieved with take().
+  /// write() then stores files immediately instead of queueing them. Must be called before any files are written.
+  void keepInMemory();
+
+  /// @brief Remove the file at path from memory and return its contents, or std::nullopt if it hasn't been written
+  std::optional<std::string> take(const std::filesystem::path& path);
+
+private:
+  struct File {
+    std::filesystem::path path;
+    std::string           contents;
+    uint64_t              inputs = 0;
+  };
+
+  /// The hash and size of a file under the manifest's root when it was last written, and of what it was generated from
+  struct ManifestEntry {
+    uint64_t hash    = 0;
+    uint64_t size    = 0;
+    uint64_t inputs  = 0;
+    bool     current = false; ///< Has the file been written or found unchanged since the manifest was loaded?
+  };
+
+  /// Write queued files until the OutputWriter is destroyed
+  void run();
+
+  /// Returns the key of path in the manifest, or an empty string if it isn't under the manifest's root
+  std::string getManifestKey(const std::filesystem::path& path) const;
+
+  /// Add a batch of files to the archive, waiting for the batches taken off the queue before it to be added first.
+  /// The number of files added and their total size are added to files and bytes.
+  void addToArchive(const std::vector<File>& batch, const uint64_t batchNumber, uint64_t& files, uint64_t& bytes);
+
+  const uint64_t           maxQueueDepth;
+  std::mutex               mutex;
+  std::condition_variable  queued;   ///< Signalled when files are added to the queue, or when stopping
+  std::condition_variable  written;  ///< Signalled when files are taken off the queue or finished being written
+  std::deque<File>         queue;
+  std::vector<std::string> freeBuffers;  ///< Buffers of written files, ready to be reused
+  uint64_t                 inFlight = 0; ///< Number of files taken off the queue that are still being written
+  bool                     stopping = false;
+  Stats                    counters;
+  std::vector<std::thread> threads;
+
+  std::filesystem::path                          manifestRoot; ///< Root of the files in the manifest, if any
+  std::unordered_map<std::string, ManifestEntry> manifest;     ///< Path relative to manifestRoot -> entry
+
+  std::unique_ptr<TarWriter> archive;               ///< Archive that files are written to instead, if any
+  std::filesystem::path      archiveRoot;           ///< Directory that names in the archive are relative to
+  uint64_t                   batchesTaken  = 0;     ///< Number of batches taken off the queue, guarded by mutex
+  std::mutex                 archiveMutex;
+  std::condition_variable    archiveTurn;           ///< Signalled when a batch has been added to the archive
+  uint64_t                   batchesAdded  = 0;     ///< Number of batches added to the archive, guarded by archiveMutex
+  bool                       archiveFailed = false; ///< Has adding a file to the archive failed?
+
+  bool                                         inMemory = false; ///< Are files kept in memory?
+  std::unordered_map<std::string, std::string> memoryFiles;      ///< Files kept in memory, by path
+};
+} // namespace hdoc::serde
@@ -0,0 +1,108 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/PreviewServer.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <httplib.h>
+#include <string_view>
+
+hdoc::serde::PreviewServer::PreviewServer(const HTMLWriter& writer, const uint64_t cacheSize)
+    : writer(writer), cacheSize(std::max<uint64_t>(cacheSize, 1)) {}
+
+std::shared_ptr<const std::string> hdoc::serde::PreviewServer::findCached(const std::string& url) {
+  const auto it = this->entries.find(url);
+  if (it == this->entries.end()) {
+    return nullptr;
+  }
+  this->lru.splice(this->lru.begin(), this->lru, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<const std::string> hdoc::serde::PreviewServer::getPage(const std::string& url) {
+  {
+    std::scoped_lock lock(this->mutex);
+    if (auto page = this->findCached(url)) {
+      return page;
+    }
+  }
+
+  // Pages are rendered one at a time, so that two requests for the same page don't both render it. Another request
+  // may have rendered the page while this one was waiting, so the cache is checked again first.
+  std::scoped_lock renderLock(this->renderMutex);
+  {
+    std::scoped_lock lock(this->mutex);
+    if (auto page = this->findCached(url)) {
+      return page;
+    }
+  }
+  auto rendered = this->writer.renderPage(url);
+  if (!rendered) {
+    return nullptr;
+  }
+  auto page = std::make_shared<const std::string>(std::move(*rendered));
+
+  std::scoped_lock lock(this->mutex);
+  this->lru.emplace_front(url, page);
+  this->entries[url] = this->lru.begin();
+  if (this->lru.size() > this->cacheSize) {
+    this->entries.erase(this->lru.back().first);
+    this->lru.pop_back();
+  }
+  return page;
+}
+
+uint64_t hdoc::serde::PreviewServer::size() {
+  std::scoped_lock lock(this->mutex);
+  return this->lru.size();
+}
+
+/// Returns the MIME type of the file at url, based on its extension
+static const char* getContentType(const std::string_view url) {
+  if (url.ends_with(".html")) {
+    return "text/html; charset=utf-8";
+  } else if (url.ends_with(".css")) {
+    return "text/css";
+  } else if (url.ends_with(".js")) {
+    return "text/javascript";
+  } else if (url.ends_with(".json")) {
+    return "application/json";
+  } else if (url.ends_with(".png")) {
+    return "image/png";
+  } else if (url.ends_with(".ico")) {
+    return "image/x-icon";
+  }
+  return "application/octet-stream";
+}
+
+bool hdoc::serde::PreviewServer::listen(const uint16_t port) {
+  httplib::Server server;
+  server.Get(".*", [this](const httplib::Request& req, httplib::Response& res) {
+    const std::string url         = req.path == "/" ? "index.html" : req.path.substr(1);
+    const char*       contentType = getContentType(url);
+
+    // Assets are served from the executable, and pages are streamed from the cache without being copied
+    if (const auto asset = HTMLWriter::getBundledAsset(url)) {
+      res.set_content(asset->data(), asset->size(), contentType);
+      return;
+    }
+    const auto page = this->getPage(url);
+    if (page == nullptr) {
+      res.status = 404;
+      res.set_content("Page not found.", "text/plain");
+      return;
+    }
+    res.set_content_provider(page->size(), contentType, [page](size_t offset, size_t length, httplib::DataSink& sink) {
+      return sink.write(page->data() + offset, length);
+    });
+  });
+
+  spdlog::info("Serving documentation at http://localhost:{}/, press Ctrl+C to exit.", port);
+  if (server.listen("localhost", port) == false) {
+    spdlog::error("Unable to serve documentation on port {}.", port);
+    return false;
+  }
+  return true;
+}
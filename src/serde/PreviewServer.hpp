@@ -0,0 +1,52 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "serde/HTMLWriter.hpp"
+
+namespace hdoc::serde {
+/// @brief Serves documentation over HTTP to preview it locally, rendering each page the first time it's requested.
+///
+/// Nothing is rendered up front, so the first page is available as soon as the project has been indexed. Rendered
+/// pages are kept in a least-recently-used cache, which bounds memory use no matter how large the project is.
+/// Bundled assets are served straight from the arrays they're compiled into.
+class PreviewServer {
+public:
+  /// @brief Serve the pages rendered by writer, keeping up to cacheSize of them in memory.
+  /// The writer's Config must have servePort set, so that pages are kept in memory instead of being written.
+  explicit PreviewServer(const HTMLWriter& writer, const uint64_t cacheSize = 1024);
+
+  /// @brief Serve on localhost at port until the process is stopped. Returns false if the server couldn't start.
+  bool listen(const uint16_t port);
+
+  /// @brief Returns the page at url, relative to the root of the documentation, or nullptr if there's no such page.
+  /// Pages are rendered if they aren't in the cache.
+  std::shared_ptr<const std::string> getPage(const std::string& url);
+
+  /// @brief Returns the number of pages in the cache
+  uint64_t size();
+
+private:
+  using CacheList = std::list<std::pair<std::string, std::shared_ptr<const std::string>>>;
+
+  /// Returns the cached page at url and marks it as the most recently used, or nullptr if it isn't cached.
+  /// mutex must be held.
+  std::shared_ptr<const std::string> findCached(const std::string& url);
+
+  const HTMLWriter&                                    writer;
+  const uint64_t                                       cacheSize;
+  std::mutex                                           mutex;       ///< Guards lru and entries
+  CacheList                                            lru;         ///< Cached pages, most recently used first
+  std::unordered_map<std::string, CacheList::iterator> entries;     ///< URL -> the page's entry in lru
+  std::mutex                                           renderMutex; ///< Held while rendering a page
+};
+} // namespace hdoc::serde
@@ -0,0 +1,654 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/PrototypeFormatter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "serde/HTMLWriter.hpp"
+
+namespace {
+/// A token from the subset of C++ that appears in prototypes
+struct Token {
+  enum class Kind { Word, Number, Literal, Punct };
+  Kind             kind;
+  std::string_view text;
+  bool             isExpression; ///< Is the token part of a default value rather than a type?
+};
+
+/// A candidate layout for a declaration, and the penalty clang-format would give it.
+/// clang-format picks the layout with the lowest penalty out of all of the ones that fit within the column limit.
+struct Layout {
+  std::string text;
+  uint64_t    penalty;
+};
+} // namespace
+
+/// Penalties that clang-format's Chromium style gives each kind of line break in a declaration, as measured from its
+/// output. Only their relative order matters, since they're used to pick between layouts the same way it does.
+static constexpr uint64_t penaltyFirstBreakInScope   = 15;  ///< Added for the first break inside each bracket pair
+static constexpr uint64_t penaltyBreakAfterComma     = 41;  ///< Breaking between parameters
+static constexpr uint64_t penaltyBreakAfterOpenParen = 140; ///< Breaking before the first parameter
+static constexpr uint64_t penaltyBreakBeforeName     = 220; ///< Putting the return type on its own line
+static constexpr uint64_t penaltyBreakBeforeArrow    = 23;  ///< Putting a trailing return type on its own line
+static constexpr uint64_t penaltyBreakInParam        = 141; ///< Lower bound for breaking inside of a parameter
+static constexpr uint64_t penaltyBreakAfterBase      = 21;  ///< Breaking between base records
+static constexpr uint64_t penaltyBreakBeforeColon    = 23;  ///< Breaking before the list of base records
+static constexpr uint64_t continuationIndent         = 4;
+
+static bool isWordChar(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+static bool isIdentifier(const std::string_view s) {
+  if (s.empty() || std::isdigit(static_cast<unsigned char>(s[0]))) {
+    return false;
+  }
+  for (const char c : s) {
+    if (isWordChar(c) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Split s into tokens and append them to tokens.
+/// Returns false if s contains something that the formatter doesn't handle.
+static bool tokenize(const std::string_view s, const bool isExpression, std::vector<Token>& tokens) {
+  // clang-format keeps C++03-style "> >" if it's used in the input, which isn't handled here
+  if (s.find("> >") != std::string_view::npos) {
+    return false;
+  }
+
+  uint64_t i = 0;
+  while (i < s.size()) {
+    const char     c     = s[i];
+    const uint64_t start = i;
+    Token::Kind    kind  = Token::Kind::Punct;
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      i++;
+      continue;
+    } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      while (i < s.size() && isWordChar(s[i])) {
+        i++;
+      }
+      // Literals with an encoding prefix, e.g. u8"text"
+      if (i < s.size() && (s[i] == '"' || s[i] == '\'')) {
+        return false;
+      }
+      // Alternative tokens for operators, e.g. "and" or "not_eq"
+      const std::string_view word = s.substr(start, i - start);
+      if (word == "and" || word == "and_eq" || word == "bitand" || word == "bitor" || word == "compl" ||
+          word == "not" || word == "not_eq" || word == "or" || word == "or_eq" || word == "xor" || word == "xor_eq") {
+        return false;
+      }
+      kind = Token::Kind::Word;
+    } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+               (c == '.' && i + 1 < s.size() && std::isdigit(static_cast<unsigned char>(s[i + 1])))) {
+      const bool isHex = s.substr(i, 2) == "0x" || s.substr(i, 2) == "0X";
+      while (i < s.size()) {
+        if (isWordChar(s[i]) || s[i] == '.' || s[i] == '\'') {
+          i++;
+        } else if ((s[i] == '+' || s[i] == '-') && isHex == false && (s[i - 1] == 'e' || s[i - 1] == 'E')) {
+          i++;
+        } else {
+          break;
+        }
+      }
+      kind = Token::Kind::Number;
+    } else if (c == '"' || c == '\'') {
+      for (i++; i < s.size() && s[i] != c; i++) {
+        i += s[i] == '\\' ? 1 : 0;
+      }
+      if (i >= s.size()) {
+        return false;
+      }
+      i++;
+      kind = Token::Kind::Literal;
+    } else if (s.substr(i, 2) == "::" || s.substr(i, 2) == "&&") {
+      i += 2;
+    } else if (s.substr(i, 3) == "...") {
+      i += 3;
+    } else if (c != '\0' && std::strchr("<>,*&()[]{}=-", c) != nullptr) {
+      i += 1;
+    } else {
+      return false;
+    }
+    tokens.push_back({kind, s.substr(start, i - start), isExpression});
+  }
+  return true;
+}
+
+static bool isPunct(const Token& t, const std::string_view p) {
+  return t.kind == Token::Kind::Punct && t.text == p;
+}
+
+static bool isPointerOrReference(const Token& t) {
+  return isPunct(t, "*") || isPunct(t, "&") || isPunct(t, "&&");
+}
+
+/// Returns whether clang-format puts a space between two adjacent tokens of a declaration,
+/// or std::nullopt if it's a combination that the formatter doesn't handle.
+static std::optional<bool> isSpaceBetween(const Token& prev, const Token& cur) {
+  const bool isExpression = cur.isExpression;
+  if (isPunct(cur, ",")) {
+    return false;
+  }
+  if (isPunct(prev, ",") || isPunct(prev, "=") || isPunct(cur, "=")) {
+    return true;
+  }
+  if (isPunct(cur, "::")) {
+    // A leading "::", e.g. "const ::ns::Type"
+    if (prev.kind == Token::Kind::Word &&
+        (prev.text == "const" || prev.text == "volatile" || prev.text == "typename" || prev.text == "struct" ||
+         prev.text == "class" || prev.text == "enum" || prev.text == "union")) {
+      return true;
+    }
+    if (prev.kind == Token::Kind::Word || isPunct(prev, ">")) {
+      return false;
+    }
+    return std::nullopt;
+  }
+  if (isPunct(prev, "::")) {
+    return cur.kind == Token::Kind::Word ? std::optional<bool>(false) : std::nullopt;
+  }
+  if (isPunct(cur, "<")) {
+    return prev.kind == Token::Kind::Word ? std::optional<bool>(prev.text == "template") : std::nullopt;
+  }
+  if (isPunct(prev, "<") || isPunct(prev, "(") || isPunct(prev, "[") || isPunct(cur, ">") || isPunct(cur, ")") ||
+      isPunct(cur, "]")) {
+    return false;
+  }
+  // Pointers and references are aligned to the left, i.e. "const int& i"
+  if (isPointerOrReference(cur)) {
+    if (isExpression == false &&
+        (prev.kind == Token::Kind::Word || isPunct(prev, ">") || isPointerOrReference(prev))) {
+      return false;
+    }
+    return std::nullopt;
+  }
+  if (isPunct(cur, "...")) {
+    if (prev.kind == Token::Kind::Word || isPunct(prev, ">") || isPointerOrReference(prev)) {
+      return false;
+    }
+    return std::nullopt;
+  }
+  if (isPunct(cur, "[")) {
+    if (isExpression == false && (prev.kind == Token::Kind::Word || isPunct(prev, "]"))) {
+      return false;
+    }
+    if (isExpression == false && isPointerOrReference(prev)) {
+      return true;
+    }
+    return std::nullopt;
+  }
+  // Calls and braced initializers are only expected in default values, e.g. "std::string()" or "Type{}"
+  if (isPunct(cur, "(") || isPunct(cur, "{")) {
+    if (isExpression && (prev.kind == Token::Kind::Word || isPunct(prev, ">"))) {
+      return false;
+    }
+    return std::nullopt;
+  }
+  if (isPunct(cur, "}")) {
+    return isPunct(prev, "{") ? std::optional<bool>(false) : std::nullopt;
+  }
+  // Negative numbers; the minus sign is always preceded by "=", "(", or "," which are handled above
+  if (isPunct(prev, "-")) {
+    return cur.kind == Token::Kind::Number ? std::optional<bool>(false) : std::nullopt;
+  }
+  if (cur.kind != Token::Kind::Punct) {
+    if (prev.kind != Token::Kind::Punct || isPunct(prev, ">") || isPointerOrReference(prev) || isPunct(prev, "...") ||
+        isPunct(prev, ")")) {
+      return true;
+    }
+  }
+  return std::nullopt;
+}
+
+/// Join tokens with the spacing that clang-format would use
+static std::optional<std::string> joinTokens(const std::vector<Token>& tokens) {
+  std::string out;
+  int64_t     depth = 0;
+  for (uint64_t i = 0; i < tokens.size(); i++) {
+    const Token& t = tokens[i];
+    if (i > 0) {
+      const auto space = isSpaceBetween(tokens[i - 1], t);
+      if (space.has_value() == false) {
+        return std::nullopt;
+      }
+      out += *space ? " " : "";
+    }
+    if (isPunct(t, "<") || isPunct(t, "(") || isPunct(t, "[") || isPunct(t, "{")) {
+      depth++;
+    } else if (isPunct(t, ">") || isPunct(t, ")") || isPunct(t, "]") || isPunct(t, "}")) {
+      depth--;
+    }
+    if (depth < 0) {
+      return std::nullopt;
+    }
+    out += t.text;
+  }
+  if (depth != 0) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+/// Format a type, or a type followed by a name and default value, e.g. "const std::string & s = \"\""
+static std::optional<std::string>
+formatDeclarator(const std::string_view type, const std::string_view name = "", const std::string_view value = "") {
+  std::vector<Token> tokens;
+  if (tokenize(type, false, tokens) == false) {
+    return std::nullopt;
+  }
+  if (name != "") {
+    if (isIdentifier(name) == false) {
+      return std::nullopt;
+    }
+    const uint64_t numTokens = tokens.size();
+    if (tokenize(name, false, tokens) == false || tokens.size() != numTokens + 1) {
+      return std::nullopt;
+    }
+  }
+  if (value != "") {
+    tokens.push_back({Token::Kind::Punct, "=", true});
+    if (tokenize(value, true, tokens) == false) {
+      return std::nullopt;
+    }
+  }
+  return joinTokens(tokens);
+}
+
+/// Returns true if every line of s fits within columnLimit
+static bool fits(const std::string_view s, const uint64_t columnLimit) {
+  uint64_t lineStart = 0;
+  while (lineStart <= s.size()) {
+    const uint64_t lineEnd = std::min(s.find('\n', lineStart), s.size());
+    if (lineEnd - lineStart > columnLimit) {
+      return false;
+    }
+    lineStart = lineEnd + 1;
+  }
+  return true;
+}
+
+/// Join items, separating them with ", " if they're on one line or with ",\n" and indent if they aren't
+static std::string joinList(const std::vector<std::string>& items, const uint64_t indent = UINT64_MAX) {
+  std::string out;
+  for (uint64_t i = 0; i < items.size(); i++) {
+    if (i > 0) {
+      out += indent == UINT64_MAX ? ", " : ",\n" + std::string(indent, ' ');
+    }
+    out += items[i];
+  }
+  return out;
+}
+
+/// Parse and format the parameters of a template header, e.g. "template <typename T, int N = 3>"
+static std::optional<std::vector<std::string>> formatTemplateParams(std::string_view header) {
+  while (header.ends_with(' ')) {
+    header.remove_suffix(1);
+  }
+  if (header.starts_with("template <") == false || header.ends_with(">") == false) {
+    return std::nullopt;
+  }
+  const std::string_view inner = header.substr(10, header.size() - 11);
+
+  // Split the parameters at the commas that aren't nested in brackets
+  std::vector<std::string> params;
+  int64_t                  depth      = 0;
+  uint64_t                 paramStart = 0;
+  for (uint64_t i = 0; i <= inner.size(); i++) {
+    const char c = i < inner.size() ? inner[i] : ',';
+    depth += (c == '<' || c == '(' || c == '[' || c == '{') ? 1 : 0;
+    depth -= (c == '>' || c == ')' || c == ']' || c == '}') ? 1 : 0;
+    if (c != ',' || depth != 0) {
+      continue;
+    }
+
+    // Defaults of type parameters are types, and defaults of non-type parameters are expressions
+    const std::string_view param    = inner.substr(paramStart, i - paramStart);
+    const uint64_t         equals   = param.find(" = ");
+    const std::string_view decl     = param.substr(0, equals);
+    const bool             isType   = decl.starts_with("typename") || decl.starts_with("class");
+    std::vector<Token>     tokens   = {};
+    bool                   isParsed = tokenize(decl, false, tokens);
+    if (equals != std::string_view::npos) {
+      tokens.push_back({Token::Kind::Punct, "=", true});
+      isParsed = isParsed && tokenize(param.substr(equals + 3), isType == false, tokens);
+    }
+    const auto formatted = isParsed ? joinTokens(tokens) : std::nullopt;
+    if (formatted.has_value() == false || formatted->empty()) {
+      return std::nullopt;
+    }
+    params.push_back(*formatted);
+    paramStart = i + 1;
+  }
+  return params;
+}
+
+/// Lay out a template header on its own line(s), with the parameters aligned if they don't fit on one line
+static std::optional<std::string> layoutTemplateHeader(const std::vector<std::string>& params,
+                                                       const uint64_t                  columnLimit) {
+  const std::string oneLine = "template <" + joinList(params) + ">";
+  if (oneLine.size() <= columnLimit) {
+    return oneLine + "\n";
+  }
+  const std::string aligned = "template <" + joinList(params, std::strlen("template <")) + ">";
+  if (fits(aligned, columnLimit)) {
+    return aligned + "\n";
+  }
+  return std::nullopt;
+}
+
+/// Returns the candidate with the lowest penalty out of the ones that fit within columnLimit
+static std::optional<Layout> pickLayout(std::vector<Layout>& candidates, const uint64_t columnLimit) {
+  std::optional<Layout> best;
+  for (auto& candidate : candidates) {
+    if (fits(candidate.text, columnLimit) && (best.has_value() == false || candidate.penalty < best->penalty)) {
+      best = std::move(candidate);
+    }
+  }
+  return best;
+}
+
+/// Find the cheapest layout of "prefix(params)suffix arrow" starting at column 0 that fits within columnLimit
+static std::optional<Layout> layoutParams(const std::string&              prefix,
+                                          const std::vector<std::string>& params,
+                                          const std::string&              suffix,
+                                          const std::string&              arrow,
+                                          const uint64_t                  columnLimit) {
+  const std::string   indent(continuationIndent, ' ');
+  std::vector<Layout> layouts;
+
+  // Everything on one line
+  layouts.push_back({prefix + "(" + joinList(params) + suffix, 0});
+  if (params.size() > 1) {
+    // One parameter per line, aligned with the opening parenthesis
+    layouts.push_back({prefix + "(" + joinList(params, prefix.size() + 1) + suffix,
+                       penaltyFirstBreakInScope + penaltyBreakAfterComma * (params.size() - 1)});
+  }
+  if (params.size() > 0) {
+    // One parameter per line, starting on the line after the opening parenthesis
+    layouts.push_back({prefix + "(\n" + indent + joinList(params, continuationIndent) + suffix,
+                       penaltyFirstBreakInScope + penaltyBreakAfterOpenParen +
+                           penaltyBreakAfterComma * (params.size() - 1)});
+  }
+
+  // The trailing return type can go at the end of the last line or on a line by itself
+  std::vector<Layout> candidates;
+  for (const auto& layout : layouts) {
+    if (arrow == "") {
+      candidates.push_back(layout);
+      continue;
+    }
+    candidates.push_back({layout.text + " " + arrow, layout.penalty});
+    candidates.push_back({layout.text + "\n" + indent + arrow,
+                          layout.penalty + penaltyFirstBreakInScope + penaltyBreakBeforeArrow});
+  }
+  return pickLayout(candidates, columnLimit);
+}
+
+/// Lay out a function's prototype, or return std::nullopt if clang-format needs to be used instead
+static std::optional<std::string> layoutFunction(const hdoc::types::FunctionSymbol& f, const uint64_t columnLimit) {
+  const std::string_view proto = f.proto;
+  if (f.postTemplate > f.nameStart || f.nameStart > proto.size()) {
+    return std::nullopt;
+  }
+  // Without the end of the template header, it would be laid out as part of the return type
+  if (f.postTemplate == 0 && proto.starts_with("template")) {
+    return std::nullopt;
+  }
+
+  std::string out;
+  if (f.postTemplate > 0) {
+    const auto templateParams = formatTemplateParams(proto.substr(0, f.postTemplate));
+    const auto header = templateParams ? layoutTemplateHeader(*templateParams, columnLimit) : std::nullopt;
+    if (header.has_value() == false) {
+      return std::nullopt;
+    }
+    out += *header;
+  }
+
+  // Qualifiers and return type. Array return types are invalid, but clang's type printer can still produce them.
+  const auto head = formatDeclarator(proto.substr(f.postTemplate, f.nameStart - f.postTemplate));
+  if (head.has_value() == false || head->find('[') != std::string::npos) {
+    return std::nullopt;
+  }
+
+  // Name, which may be a destructor's; operators are left to clang-format
+  const std::string_view name = f.name;
+  if (isIdentifier(name.starts_with("~") ? name.substr(1) : name) == false || name.starts_with("operator") ||
+      proto.substr(f.nameStart, name.size() + 1) != f.name + "(") {
+    return std::nullopt;
+  }
+  uint64_t pos = f.nameStart + name.size() + 1;
+
+  // Parameters are checked against the prototype to make sure that they're what it was generated from
+  std::vector<std::string> params;
+  for (const auto& param : f.params) {
+    std::string raw = params.empty() ? "" : ", ";
+    raw += param.type.name;
+    raw += param.name != "" ? " " + param.name : "";
+    raw += param.defaultValue != "" ? " = " + param.defaultValue : "";
+    const auto formatted = formatDeclarator(param.type.name, param.name, param.defaultValue);
+    if (proto.compare(pos, raw.size(), raw) != 0 || formatted.has_value() == false) {
+      return std::nullopt;
+    }
+    params.push_back(*formatted);
+    pos += raw.size();
+  }
+  if (f.isVariadic) {
+    const std::string_view raw = params.empty() ? "..." : ", ...";
+    if (proto.compare(pos, raw.size(), raw) != 0) {
+      return std::nullopt;
+    }
+    params.push_back("...");
+    pos += raw.size();
+  }
+  if (proto.compare(pos, 1, ")") != 0) {
+    return std::nullopt;
+  }
+  pos += 1;
+
+  // Qualifiers after the parameters, and the trailing return type
+  std::string_view qualifiers = proto.substr(pos);
+  std::string      arrow      = "";
+  if (f.hasTrailingReturn) {
+    // clang-format treats a ref-qualifier or "...)" before a trailing return type as part of an expression
+    const uint64_t arrowPos = qualifiers.find(" -> ");
+    if (arrowPos == std::string_view::npos || f.refQualifier != clang::RQ_None || f.isVariadic) {
+      return std::nullopt;
+    }
+    const auto type = formatDeclarator(qualifiers.substr(arrowPos + 4));
+    if (type.has_value() == false) {
+      return std::nullopt;
+    }
+    arrow      = "-> " + *type;
+    qualifiers = qualifiers.substr(0, arrowPos);
+  }
+  std::vector<Token> tokens;
+  if (tokenize(qualifiers, false, tokens) == false) {
+    return std::nullopt;
+  }
+  std::string suffix = ")";
+  for (uint64_t i = 0; i < tokens.size(); i++) {
+    const Token& t = tokens[i];
+    if (isPunct(t, "&") || isPunct(t, "&&")) {
+      // Ref-qualifiers are attached to cv-qualifiers, e.g. "f() const&", but not to the parameters
+      suffix += i > 0 && tokens[i - 1].kind == Token::Kind::Word ? "" : " ";
+    } else if (t.text == "const" || t.text == "volatile" || t.text == "noexcept") {
+      suffix += " ";
+    } else {
+      return std::nullopt;
+    }
+    suffix += t.text;
+  }
+
+  // Lay out the rest of the declaration on one line with the return type, or after the return type if that's cheaper.
+  // The template header always ends with a line break, so breaking at the same level again isn't as bad.
+  const std::string prefix            = *head == "" ? f.name : *head + " " + f.name;
+  const bool        canBreakAfterHead = f.isCtorOrDtor == false && *head != "" && head->size() <= columnLimit;
+  const uint64_t    penaltyAfterHead  = penaltyBreakBeforeName + (f.postTemplate > 0 ? 0 : penaltyFirstBreakInScope);
+  auto              best              = layoutParams(prefix, params, suffix, arrow, columnLimit);
+  if (canBreakAfterHead) {
+    auto afterHead = layoutParams(f.name, params, suffix, arrow, columnLimit);
+    if (afterHead.has_value() && (best.has_value() == false || afterHead->penalty + penaltyAfterHead < best->penalty)) {
+      best          = std::move(afterHead);
+      best->text    = *head + "\n" + best->text;
+      best->penalty = best->penalty + penaltyAfterHead;
+    }
+  }
+  if (best.has_value() == false) {
+    return std::nullopt;
+  }
+
+  // clang-format can also break inside a parameter (e.g. before its name, after "=", or in its template arguments) or
+  // before the qualifiers. Those layouts aren't generated, so leave it to clang-format if one of them might be cheaper.
+  uint64_t lowerBound = UINT64_MAX;
+  if (params.empty() == false) {
+    // Breaking between the arguments of a call in a default value is cheap, unlike breaking between template arguments
+    const bool hasCallWithArgs = std::any_of(params.begin(), params.end(), [](const std::string& p) {
+      return p.find(',') != std::string::npos && p.find_first_of("({") != std::string::npos;
+    });
+    const uint64_t penaltyInParams = penaltyFirstBreakInScope + penaltyBreakAfterComma * (params.size() - 1) +
+                                     (hasCallWithArgs ? 0 : penaltyBreakInParam);
+    // Parameters can only start on the same line as the name if there's room for at least part of the first one
+    const std::string firstToken = params.front().substr(0, params.front().find_first_of(" <:*&,"));
+    if (fits(prefix + "(" + firstToken, columnLimit)) {
+      lowerBound = penaltyInParams;
+    }
+    lowerBound = std::min(lowerBound, penaltyInParams + penaltyBreakAfterOpenParen);
+    if (canBreakAfterHead) {
+      lowerBound = std::min(lowerBound, penaltyInParams + penaltyAfterHead);
+    }
+  }
+  if (suffix != ")") {
+    if (fits(prefix + "(" + joinList(params) + ")", columnLimit)) {
+      lowerBound = std::min(lowerBound, penaltyFirstBreakInScope + penaltyBreakInParam);
+    }
+    if (canBreakAfterHead && fits(f.name + "(" + joinList(params) + ")", columnLimit)) {
+      lowerBound = std::min(lowerBound, penaltyFirstBreakInScope + penaltyBreakInParam + penaltyAfterHead);
+    }
+  }
+  if (arrow != "") {
+    // A trailing return type made of several words, like "const char*", is cheap to break between them
+    const bool hasSeveralWords = std::count(arrow.begin(), arrow.end(), ' ') > 1;
+    lowerBound = std::min(lowerBound, hasSeveralWords ? 1 : penaltyFirstBreakInScope + penaltyBreakInParam);
+  }
+  if (f.isConst && f.isVolatile) {
+    // Breaking between "const" and "volatile" is cheaper than any of the generated layouts
+    lowerBound = 1;
+  }
+  if (best->penalty >= lowerBound) {
+    return std::nullopt;
+  }
+  return out + best->text;
+}
+
+/// Lay out a record's prototype, or return std::nullopt if clang-format needs to be used instead
+static std::optional<std::string> layoutRecord(const hdoc::types::RecordSymbol& c, const uint64_t columnLimit) {
+  std::string_view proto = c.proto;
+  std::string      out;
+  if (proto.starts_with("template <")) {
+    // Find the closing bracket of the template header
+    uint64_t end   = 0;
+    int64_t  depth = 0;
+    for (uint64_t i = std::strlen("template "); i < proto.size() && end == 0; i++) {
+      depth += proto[i] == '<' ? 1 : 0;
+      depth -= proto[i] == '>' ? 1 : 0;
+      end = depth == 0 ? i : 0;
+    }
+    const auto templateParams = end > 0 ? formatTemplateParams(proto.substr(0, end + 1)) : std::nullopt;
+    const auto header = templateParams ? layoutTemplateHeader(*templateParams, columnLimit) : std::nullopt;
+    if (header.has_value() == false || proto.substr(end + 1, 1) != " ") {
+      return std::nullopt;
+    }
+    out += *header;
+    proto.remove_prefix(end + 2);
+  }
+
+  const std::string raw  = c.type + " " + c.name;
+  const auto        decl = formatDeclarator(raw);
+  if (proto.starts_with(raw) == false || decl.has_value() == false) {
+    return std::nullopt;
+  }
+  proto.remove_prefix(raw.size());
+
+  // Base records are checked against the prototype to make sure that it was generated from them
+  std::vector<std::string> bases;
+  std::string              rawBases = c.baseRecords.empty() ? "" : " : ";
+  for (const auto& base : c.baseRecords) {
+    std::string rawBase = base.access == clang::AS_public      ? "public "
+                          : base.access == clang::AS_private   ? "private "
+                          : base.access == clang::AS_protected ? "protected "
+                                                               : "";
+    rawBase += base.name;
+    rawBases += bases.empty() ? "" : ", ";
+    rawBases += rawBase;
+    const auto formatted = formatDeclarator(rawBase);
+    if (formatted.has_value() == false) {
+      return std::nullopt;
+    }
+    bases.push_back(*formatted);
+  }
+  if (proto != rawBases) {
+    return std::nullopt;
+  }
+
+  std::vector<Layout> candidates;
+  if (bases.empty()) {
+    candidates.push_back({*decl, 0});
+  } else {
+    // On one line, then with the base records aligned after the colon, and then on the lines after the name.
+    // clang-format only keeps the base records of partial specializations together after breaking before the colon,
+    // since it doesn't recognize the colon as the start of a list of base records when the name has template args.
+    const std::string nextLine = *decl + "\n" + std::string(continuationIndent, ' ') + ": ";
+    candidates.push_back({*decl + " : " + joinList(bases), 0});
+    if (bases.size() == 1 || c.name.find('<') != std::string::npos) {
+      candidates.push_back({nextLine + joinList(bases), penaltyFirstBreakInScope + penaltyBreakBeforeColon});
+    }
+    if (bases.size() > 1) {
+      candidates.push_back({*decl + " : " + joinList(bases, decl->size() + 3),
+                            penaltyFirstBreakInScope + penaltyBreakAfterBase * (bases.size() - 1)});
+      candidates.push_back({nextLine + joinList(bases, continuationIndent + 2),
+                            penaltyFirstBreakInScope + penaltyBreakBeforeColon +
+                                penaltyBreakAfterBase * (bases.size() - 1)});
+    }
+  }
+  const auto best = pickLayout(candidates, columnLimit);
+  if (best.has_value() == false) {
+    return std::nullopt;
+  }
+  return out + best->text;
+}
+
+std::string hdoc::serde::formatFunctionProto(const hdoc::types::FunctionSymbol& f, const uint64_t columnLimit) {
+  const auto formatted = layoutFunction(f, columnLimit);
+  return formatted.has_value() ? *formatted : clangFormat(f.proto, columnLimit);
+}
+
+std::string hdoc::serde::formatRecordProto(const hdoc::types::RecordSymbol& c, const uint64_t columnLimit) {
+  const auto formatted = layoutRecord(c, columnLimit);
+  return formatted.has_value() ? *formatted : clangFormat(c.proto, columnLimit);
+}
+
+std::string hdoc::serde::formatTypeName(const std::string& typeName, const uint64_t columnLimit) {
+  thread_local std::unordered_map<uint64_t, std::unordered_map<std::string, std::string>> cache;
+
+  auto& entries = cache[columnLimit];
+  if (const auto it = entries.find(typeName); it != entries.end()) {
+    return it->second;
+  }
+  const auto formatted = formatDeclarator(typeName);
+  const auto result    = formatted.has_value() && formatted->size() <= columnLimit ? *formatted
+                                                                                  : clangFormat(typeName, columnLimit);
+  entries.emplace(typeName, result);
+  return result;
+}
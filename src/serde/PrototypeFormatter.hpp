@@ -0,0 +1,27 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "types/Symbols.hpp"
+
+namespace hdoc::serde {
+/// @brief Format a function's prototype for display, wrapping it to columnLimit.
+///
+/// The output is the same as clangFormat(f.proto, columnLimit), but it's laid out directly from the function's
+/// template parameters, return type, name, parameters, and qualifiers instead of running clang-format over it.
+/// clang-format is only used for prototypes that contain something the layout engine doesn't handle, such as
+/// operators or function pointers, or that are long enough that clang-format might break in the middle of a parameter.
+std::string formatFunctionProto(const hdoc::types::FunctionSymbol& f, const uint64_t columnLimit = 50);
+
+/// @brief Format a record's prototype (template parameters, name, and base records) for display.
+/// The output is the same as clangFormat(c.proto, columnLimit).
+std::string formatRecordProto(const hdoc::types::RecordSymbol& c, const uint64_t columnLimit = 70);
+
+/// @brief Format a type name for display. The output is the same as clangFormat(typeName, columnLimit).
+/// The same types are used over and over again in a project, so the results are cached for each thread.
+std::string formatTypeName(const std::string& typeName, const uint64_t columnLimit = 50);
+} // namespace hdoc::serde
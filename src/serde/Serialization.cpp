@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 
 #include "serde/Serialization.hpp"
+#include "support/IndexTables.hpp"
 #include "types/Symbols.hpp"
 
 #include "spdlog/spdlog.h"
@@ -34,7 +35,7 @@ template <class Archive> static void serialize(Archive& archive, hdoc::types::Te
 }
 
 template <class Archive> static void serialize(Archive& archive, hdoc::types::Symbol& s) {
-  archive(s.name, s.briefComment, s.docComment, s.ID, s.file, s.line, s.parentNamespaceID);
+  archive(s.name, s.briefComment, s.docComment, s.ID, s.file, s.line, s.parentNamespaceID, s.fingerprint);
 }
 
 template <class Archive> static void serialize(Archive& archive, hdoc::types::MemberVariable& s) {
@@ -52,15 +53,21 @@ template <class Archive> static void serialize(Archive& archive, hdoc::types::Re
           s.vars,
           s.methodIDs,
           s.baseRecords,
-          s.templateParams);
+          s.templateParams,
+          s.usedByFunctionIDs,
+          s.usedByRecordIDs);
 }
 
 template <class Archive> static void serialize(Archive& archive, hdoc::types::FunctionParam& s) {
   archive(s.name, s.type, s.defaultValue, s.docComment);
 }
 
+template <class Archive> static void serialize(Archive& archive, hdoc::types::TypeRef::Token& s) {
+  archive(s.start, s.length, s.id, s.externalURL);
+}
+
 template <class Archive> static void serialize(Archive& archive, hdoc::types::TypeRef& s) {
-  archive(s.name, s.id);
+  archive(s.name, s.id, s.externalURL, s.tokens);
 }
 
 template <class Archive> static void serialize(Archive& archive, hdoc::types::FunctionSymbol& s) {
@@ -78,6 +85,7 @@ template <class Archive> static void serialize(Archive& archive, hdoc::types::Fu
           s.hasTrailingReturn,
           s.isCtorOrDtor,
           s.nameStart,
+          s.postTemplate,
           s.access,
           s.storageClass,
           s.refQualifier,
@@ -168,6 +176,24 @@ std::string serialize(const hdoc::types::Index& index, const hdoc::types::Config
   return ss.str();
 }
 
+bool loadArchive(const std::filesystem::path& path, hdoc::types::Index& index, hdoc::types::Config& cfg) {
+  std::ifstream indexArchive(path, std::ios::binary);
+  if (!indexArchive) {
+    spdlog::error("Unable to open archive {}.", path.string());
+    return false;
+  }
+
+  // The Markdown files at the end of the archive aren't needed, so they're not read
+  try {
+    cereal::PortableBinaryInputArchive archive(indexArchive);
+    archive(index, cfg);
+  } catch (const cereal::Exception& e) {
+    spdlog::error("Unable to read archive {} ({}).", path.string(), e.what());
+    return false;
+  }
+  return true;
+}
+
 void deserialize(hdoc::types::Index& index, hdoc::types::Config& cfg) {
   // Unarchive serialized file from disk
   // The actual work has to happen after destruction of archive
@@ -179,34 +205,23 @@ void deserialize(hdoc::types::Index& index, hdoc::types::Config& cfg) {
     archive(index, cfg, serializedFiles);
   }
 
-  if (serializedFiles.size() > 0) {
-    // A temporary directory for the markdown files to be dumped into
-    // This is some awful code, but it gets the job done and I have other things to deal with
-    // TODO: improve this someday
-    std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "hdoc-markdown-dump";
-    std::filesystem::create_directories(tmpDir);
-    for (uint32_t i = 0; i < UINT32_MAX; i++) {
-      const auto path = tmpDir / ("dump" + std::to_string(i)).c_str();
-      if (std::filesystem::exists(path) == false) {
-        std::filesystem::create_directories(path);
-        tmpDir = path;
-        break;
-      }
-    }
-
-    // Serialized Markdown files are "recreated" (dumped) to a temporary directory
-    // The Config object used by the server is then recreated as a copy of the client's
-    // but with the paths readjusted
-    for (const auto& f : serializedFiles) {
-      std::ofstream(tmpDir / f.filename) << f.contents;
-      // The homepage isn't added to mdPaths, we don't want it to appear in the sidebar
-      if (f.isHomepage == true) {
-        cfg.homepage = std::filesystem::path(tmpDir / f.filename);
-        continue;
-      }
-      cfg.mdPaths.push_back(tmpDir / f.filename);
+  // Serialized Markdown files are kept in memory, under paths made from their filenames that the HTMLWriter looks
+  // them up by. The homepage gets a path of its own in case one of the other pages has the same filename.
+  for (auto& f : serializedFiles) {
+    // The homepage isn't added to mdPaths, we don't want it to appear in the sidebar
+    if (f.isHomepage == true) {
+      cfg.homepage                          = std::filesystem::path("homepage") / f.filename;
+      cfg.mdContents[cfg.homepage.string()] = std::move(f.contents);
+      continue;
     }
+    cfg.mdPaths.push_back(f.filename);
+    cfg.mdContents[f.filename] = std::move(f.contents);
   }
+
+  // The tables derived from the symbols aren't serialized, so they're rebuilt the same way the Indexer builds them
+  llvm::ThreadPool pool;
+  hdoc::utils::computeAncestry(index, pool);
+  hdoc::utils::computeCollation(index, pool);
 }
 
 bool verify() {
@@ -250,7 +265,7 @@ void uploadDocs(const std::string_view data) {
   httplib::Headers headers{
       {"Authorization", "Api-Key " + api_key},
       {"Content-Disposition", "inline;filename=docs.archive"},
-      {"X-Schema-Version", "v4"},
+      {"X-Schema-Version", "v9"},
   };
 
   const auto res = cli.Put("/api/upload/", headers, data.data(), data.size(), "application/octet-stream");
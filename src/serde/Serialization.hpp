@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <filesystem>
+
 #include "types/Config.hpp"
 #include "types/Index.hpp"
 
@@ -13,6 +15,10 @@ std::string serialize(const hdoc::types::Index& index, const hdoc::types::Config
 /// @brief Deserialize hdoc's index in binary format back to it's normal form
 void deserialize(hdoc::types::Index& index, hdoc::types::Config& cfg);
 
+/// @brief Read the Index and Config from an archive created by serialize(), without restoring its Markdown files.
+/// Returns false if the archive can't be read.
+bool loadArchive(const std::filesystem::path& path, hdoc::types::Index& index, hdoc::types::Config& cfg);
+
 /// @brief Verify that the user's API key is valid prior to uploading documentation
 bool verify();
 
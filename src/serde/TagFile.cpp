@@ -0,0 +1,133 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/TagFile.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+bool hdoc::serde::TagFile::write(const hdoc::types::Index&    index,
+                                 const std::string_view       baseURL,
+                                 const std::filesystem::path& path,
+                                 const bool                   sharded) {
+  std::vector<Entry> entries;
+  std::string        strings;
+
+  // Strings are appended to the string table as entries are added, entries are sorted afterwards
+  const auto addEntry = [&](const hdoc::types::Symbol& s, const TagKind kind, const std::string& url) {
+    Entry e      = {};
+    e.id         = s.ID.raw();
+    e.kind       = static_cast<uint8_t>(kind);
+    e.nameOffset = strings.size();
+    e.nameLength = s.name.size();
+    strings += s.name;
+    e.urlOffset = strings.size();
+    e.urlLength = baseURL.size() + url.size();
+    strings += baseURL;
+    strings += url;
+    entries.push_back(e);
+  };
+
+  for (const auto& [id, f] : index.functions.entries) {
+    // Methods don't have their own pages
+    if (f.isRecordMember == false) {
+      addEntry(f, TagKind::Function, f.url(sharded));
+    }
+  }
+  for (const auto& [id, r] : index.records.entries) {
+    addEntry(r, TagKind::Record, r.url(sharded));
+  }
+  for (const auto& [id, e] : index.enums.entries) {
+    addEntry(e, TagKind::Enum, e.url(sharded));
+  }
+  for (const auto& [id, n] : index.namespaces.entries) {
+    // Namespaces don't have their own pages either, they're all documented on namespaces.html
+    addEntry(n, TagKind::Namespace, "namespaces.html#" + n.ID.str());
+  }
+  if (strings.size() > std::numeric_limits<uint32_t>::max()) {
+    spdlog::error("Too many symbols to write a tag file to {}.", path.string());
+    return false;
+  }
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+
+  Header header = {};
+  std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+  header.version           = fileVersion;
+  header.numEntries        = entries.size();
+  header.stringTableOffset = sizeof(Header) + entries.size() * sizeof(Entry);
+
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+  out.write(strings.data(), strings.size());
+  out.close();
+  if (!out) {
+    spdlog::error("Unable to write tag file to {}.", path.string());
+    return false;
+  }
+  spdlog::info("Wrote {} tags to {}.", entries.size(), path.string());
+  return true;
+}
+
+std::unique_ptr<hdoc::serde::TagFile> hdoc::serde::TagFile::load(const std::filesystem::path& path, std::string& err) {
+  auto buffer = llvm::MemoryBuffer::getFile(path.string(), /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!buffer) {
+    err = buffer.getError().message();
+    return nullptr;
+  }
+
+  // Check that the file is a tag file and that it's as large as the header says it is
+  const llvm::StringRef data = buffer->get()->getBuffer();
+  if (data.size() < sizeof(Header)) {
+    err = "file is too small to be a tag file";
+    return nullptr;
+  }
+  const auto* header = reinterpret_cast<const Header*>(data.data());
+  if (std::memcmp(header->magic, fileMagic, sizeof(fileMagic)) != 0) {
+    err = "file is not a tag file";
+    return nullptr;
+  }
+  if (header->version != fileVersion) {
+    err = "unsupported tag file version " + std::to_string(header->version);
+    return nullptr;
+  }
+  const uint64_t numEntries        = header->numEntries;
+  const uint64_t stringTableOffset = header->stringTableOffset;
+  if (numEntries > (data.size() - sizeof(Header)) / sizeof(Entry) ||
+      stringTableOffset != sizeof(Header) + numEntries * sizeof(Entry)) {
+    err = "tag file is truncated or corrupted";
+    return nullptr;
+  }
+
+  auto tags        = std::unique_ptr<TagFile>(new TagFile(std::move(*buffer)));
+  tags->entries    = reinterpret_cast<const Entry*>(data.data() + sizeof(Header));
+  tags->numEntries = numEntries;
+  tags->strings    = std::string_view(data.data() + stringTableOffset, data.size() - stringTableOffset);
+  return tags;
+}
+
+std::optional<hdoc::serde::TagFile::Tag> hdoc::serde::TagFile::find(const hdoc::types::SymbolID& id) const {
+  const Entry* end = this->entries + this->numEntries;
+  const Entry* it =
+      std::lower_bound(this->entries, end, id.raw(), [](const Entry& e, const uint64_t id) { return e.id < id; });
+  if (it == end || it->id != id.raw()) {
+    return std::nullopt;
+  }
+
+  // Offsets come from the file, so check them before trusting them
+  if (uint64_t(it->nameOffset) + it->nameLength > this->strings.size() ||
+      uint64_t(it->urlOffset) + it->urlLength > this->strings.size()) {
+    return std::nullopt;
+  }
+  Tag tag;
+  tag.id.hashValue = it->id;
+  tag.kind         = static_cast<TagKind>(it->kind);
+  tag.name         = this->strings.substr(it->nameOffset, it->nameLength);
+  tag.url          = this->strings.substr(it->urlOffset, it->urlLength);
+  return tag;
+}
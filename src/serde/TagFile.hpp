@@ -0,0 +1,91 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "types/Index.hpp"
+
+namespace hdoc::serde {
+/// @brief The type of symbol a tag refers to
+enum class TagKind : uint8_t {
+  Function  = 0,
+  Record    = 1,
+  Enum      = 2,
+  Namespace = 3,
+};
+
+/// @brief A tag file lists the symbols documented by a project and the URLs of their pages.
+/// Other projects import it to link to those symbols without indexing the project again.
+///
+/// The file is a fixed-size header, followed by an array of fixed-size entries sorted by SymbolID, followed by a
+/// table of the strings the entries point to. All integers are little-endian. This allows a tag file to be used
+/// directly after memory-mapping it, without any parsing, and for symbols to be looked up by binary search.
+class TagFile {
+public:
+  /// @brief A single symbol in a tag file
+  struct Tag {
+    hdoc::types::SymbolID id;
+    TagKind               kind;
+    std::string_view      name; ///< Name of the symbol, without its enclosing namespaces or records
+    std::string_view      url;  ///< URL of the symbol's documentation page
+  };
+
+  /// @brief Write a tag file for all of the functions, records, enums, and namespaces in index.
+  /// Each symbol's page URL is prefixed with baseURL, which should be where the documentation will be hosted.
+  /// If sharded, the URLs point to pages in the subdirectories that they're written to when shard_pages is set.
+  /// Returns false if the file couldn't be written.
+  static bool write(const hdoc::types::Index&    index,
+                    const std::string_view       baseURL,
+                    const std::filesystem::path& path,
+                    const bool                   sharded = false);
+
+  /// @brief Memory-map a tag file. Returns nullptr and sets err if the file can't be read or isn't a tag file.
+  static std::unique_ptr<TagFile> load(const std::filesystem::path& path, std::string& err);
+
+  /// @brief Find the tag for a symbol, if this tag file contains it
+  std::optional<Tag> find(const hdoc::types::SymbolID& id) const;
+
+  /// @brief Returns the number of tags in this tag file
+  uint64_t size() const {
+    return this->numEntries;
+  }
+
+private:
+  struct Header {
+    char                       magic[8];
+    llvm::support::ulittle32_t version;
+    llvm::support::ulittle32_t reserved;
+    llvm::support::ulittle64_t numEntries;
+    llvm::support::ulittle64_t stringTableOffset;
+  };
+
+  struct Entry {
+    llvm::support::ulittle64_t id;
+    llvm::support::ulittle32_t nameOffset;
+    llvm::support::ulittle32_t nameLength;
+    llvm::support::ulittle32_t urlOffset;
+    llvm::support::ulittle32_t urlLength;
+    uint8_t                    kind;
+    uint8_t                    reserved[7];
+  };
+
+  static constexpr char     fileMagic[8] = {'H', 'D', 'O', 'C', 'T', 'A', 'G', 'S'};
+  static constexpr uint32_t fileVersion  = 1;
+
+  explicit TagFile(std::unique_ptr<llvm::MemoryBuffer> buffer) : buffer(std::move(buffer)) {}
+
+  std::unique_ptr<llvm::MemoryBuffer> buffer;
+  const Entry*                        entries    = nullptr;
+  uint64_t                            numEntries = 0;
+  std::string_view                    strings;
+};
+} // namespace hdoc::serde
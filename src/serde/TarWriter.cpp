@@ -0,0 +1,151 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "serde/TarWriter.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+/// Size of a tar header, and the granularity of everything in an archive
+static constexpr uint64_t blockSize = 512;
+
+std::unique_ptr<hdoc::serde::TarWriter> hdoc::serde::TarWriter::open(const std::filesystem::path& path,
+                                                                    std::string&                 err) {
+  // stdout is duplicated, so that closing the archive doesn't close stdout
+  const int fd =
+      path == "-" ? dup(STDOUT_FILENO) : ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    err = std::strerror(errno);
+    return nullptr;
+  }
+
+  gzFile            gz       = nullptr;
+  const std::string filename = path.filename().string();
+  if (filename.ends_with(".gz") || filename.ends_with(".tgz")) {
+    gz = gzdopen(fd, "wb");
+    if (gz == nullptr) {
+      err = "unable to start gzip compression";
+      close(fd);
+      return nullptr;
+    }
+    // Pages are small and numerous, so a larger buffer lets zlib compress them in fewer, larger chunks
+    gzbuffer(gz, 256 * 1024);
+  }
+
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  return std::unique_ptr<TarWriter>(
+      new TarWriter(fd, gz, std::chrono::duration_cast<std::chrono::seconds>(now).count()));
+}
+
+hdoc::serde::TarWriter::~TarWriter() {
+  this->finish();
+}
+
+bool hdoc::serde::TarWriter::writeRaw(const char* data, const uint64_t size) {
+  if (this->failed) {
+    return false;
+  }
+  if (this->gz != nullptr) {
+    // gzwrite() takes an unsigned int, so very large files are written in chunks
+    for (uint64_t written = 0; written < size;) {
+      const unsigned chunk = static_cast<unsigned>(std::min<uint64_t>(size - written, 1 << 30));
+      if (gzwrite(this->gz, data + written, chunk) != static_cast<int>(chunk)) {
+        this->failed = true;
+        return false;
+      }
+      written += chunk;
+    }
+    return true;
+  }
+  for (uint64_t written = 0; written < size;) {
+    const ssize_t n = ::write(this->fd, data + written, size - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      this->failed = true;
+      return false;
+    }
+    written += n;
+  }
+  return true;
+}
+
+bool hdoc::serde::TarWriter::writePadded(const std::string_view data) {
+  static constexpr char zeroes[blockSize] = {};
+  const uint64_t        padding           = (blockSize - data.size() % blockSize) % blockSize;
+  return this->writeRaw(data.data(), data.size()) && this->writeRaw(zeroes, padding);
+}
+
+/// Write value into field as a zero-padded octal number followed by a NUL, the way ustar stores numbers
+static void setOctal(char* field, const uint64_t fieldSize, const uint64_t value) {
+  std::snprintf(field, fieldSize, "%0*llo", static_cast<int>(fieldSize - 1), static_cast<unsigned long long>(value));
+}
+
+bool hdoc::serde::TarWriter::writeHeader(const char type, const std::string_view name, const uint64_t size) {
+  // Offsets and sizes of the ustar header's fields
+  char header[blockSize] = {};
+  std::memcpy(header, name.data(), std::min<uint64_t>(name.size(), 100));
+  setOctal(header + 100, 8, 0644);
+  setOctal(header + 108, 8, 0);
+  setOctal(header + 116, 8, 0);
+  setOctal(header + 124, 12, size);
+  setOctal(header + 136, 12, this->mtime);
+  header[156] = type;
+  std::memcpy(header + 257, "ustar", 6);
+  std::memcpy(header + 263, "00", 2);
+
+  // The checksum is computed with its own field filled with spaces
+  std::memset(header + 148, ' ', 8);
+  uint64_t checksum = 0;
+  for (const unsigned char c : header) {
+    checksum += c;
+  }
+  std::snprintf(header + 148, 8, "%06llo", static_cast<unsigned long long>(checksum));
+  return this->writeRaw(header, blockSize);
+}
+
+bool hdoc::serde::TarWriter::add(const std::string_view name, const std::string_view contents) {
+  // Names that don't fit in the header are given in a pax extended header, whose record is "<length> path=<name>\n"
+  // where the length includes the digits of the length itself
+  if (name.size() > 100) {
+    const uint64_t recordSize = name.size() + std::strlen(" path=\n");
+    uint64_t       length     = recordSize + 1;
+    while (recordSize + std::to_string(length).size() != length) {
+      length++;
+    }
+    const std::string record = std::to_string(length) + " path=" + std::string(name) + "\n";
+    if (!this->writeHeader('x', "PaxHeader", record.size()) || !this->writePadded(record)) {
+      return false;
+    }
+  }
+  return this->writeHeader('0', name, contents.size()) && this->writePadded(contents);
+}
+
+bool hdoc::serde::TarWriter::finish() {
+  if (this->finished) {
+    return !this->failed;
+  }
+  this->finished = true;
+
+  // An archive ends with two blocks of zeroes
+  static constexpr char end[blockSize * 2] = {};
+  this->writeRaw(end, sizeof(end));
+  if (this->gz != nullptr) {
+    // gzclose() also closes the file descriptor
+    this->failed |= gzclose(this->gz) != Z_OK;
+  } else {
+    this->failed |= close(this->fd) != 0;
+  }
+  if (this->failed) {
+    spdlog::error("Unable to write the output archive.");
+  }
+  return !this->failed;
+}
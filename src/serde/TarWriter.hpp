@@ -0,0 +1,56 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <zlib.h>
+
+namespace hdoc::serde {
+/// @brief Writes files one after another into a single tar archive, optionally compressed with gzip.
+///
+/// Files are streamed into the archive as they're added, so nothing but the archive itself is written to the
+/// filesystem. Entries use the POSIX ustar format, with a pax extended header for names that don't fit in it.
+class TarWriter {
+public:
+  /// @brief Open an archive for writing, replacing it if it exists. "-" writes the archive to stdout.
+  /// The archive is compressed with gzip if path ends in ".gz" or ".tgz".
+  /// Returns nullptr and sets err if the archive can't be opened.
+  static std::unique_ptr<TarWriter> open(const std::filesystem::path& path, std::string& err);
+
+  /// @brief Finish the archive if finish() hasn't been called yet
+  ~TarWriter();
+  TarWriter(const TarWriter&)            = delete;
+  TarWriter& operator=(const TarWriter&) = delete;
+
+  /// @brief Append a regular file to the archive. name is its path inside the archive, using '/' as the separator.
+  /// Returns false if it couldn't be written, after which the archive is unusable.
+  bool add(const std::string_view name, const std::string_view contents);
+
+  /// @brief Write the end-of-archive marker and close the archive. Returns false if any part of it couldn't be written.
+  bool finish();
+
+private:
+  TarWriter(const int fd, gzFile gz, const uint64_t mtime) : fd(fd), gz(gz), mtime(mtime) {}
+
+  /// Write a 512-byte header for an entry of the given type, name, and size
+  bool writeHeader(const char type, const std::string_view name, const uint64_t size);
+
+  /// Write data followed by zeroes up to the next 512-byte boundary
+  bool writePadded(const std::string_view data);
+
+  /// Write raw bytes to the archive, compressing them if it's a gzip archive
+  bool writeRaw(const char* data, const uint64_t size);
+
+  int            fd       = -1;      ///< Archive's file descriptor, which gz writes to if the archive is compressed
+  gzFile         gz       = nullptr; ///< Compressed stream, or nullptr for an uncompressed archive
+  const uint64_t mtime    = 0;       ///< Modification time given to every entry, when the archive was opened
+  bool           failed   = false;
+  bool           finished = false;
+};
+} // namespace hdoc::serde
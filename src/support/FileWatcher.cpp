@@ -0,0 +1,123 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/FileWatcher.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+hdoc::utils::FileWatcher::FileWatcher() {
+#ifdef __linux__
+  this->fd = inotify_init1(IN_CLOEXEC);
+  if (this->fd < 0) {
+    spdlog::warn("Unable to initialize inotify ({}), falling back to polling for file changes.", std::strerror(errno));
+  }
+#endif
+}
+
+hdoc::utils::FileWatcher::~FileWatcher() {
+#ifdef __linux__
+  if (this->fd >= 0) {
+    close(this->fd);
+  }
+#endif
+}
+
+void hdoc::utils::FileWatcher::addFile(const std::filesystem::path& path) {
+  const std::filesystem::path normalized = path.lexically_normal();
+  if (this->files.find(normalized.string()) != this->files.end()) {
+    return;
+  }
+
+  std::error_code ec;
+  const auto      mtime = std::filesystem::last_write_time(normalized, ec);
+  this->files.emplace(normalized.string(), ec ? std::filesystem::file_time_type::min() : mtime);
+
+#ifdef __linux__
+  if (this->fd >= 0) {
+    const std::filesystem::path dir = normalized.parent_path();
+    if (this->watchedDirs.insert(dir.string()).second == false) {
+      return;
+    }
+    const int wd = inotify_add_watch(this->fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE);
+    if (wd < 0) {
+      spdlog::warn("Unable to watch directory {} for changes: {}", dir.string(), std::strerror(errno));
+      return;
+    }
+    this->watchDescriptors[wd] = dir;
+  }
+#endif
+}
+
+std::vector<std::string> hdoc::utils::FileWatcher::waitForChanges(const std::chrono::milliseconds debounce) {
+  std::unordered_set<std::string> changed;
+
+#ifdef __linux__
+  if (this->fd >= 0) {
+    alignas(inotify_event) char buf[4096];
+
+    // Block indefinitely for the first event, then only wait for the debounce period for any stragglers
+    int timeout = -1;
+    while (true) {
+      pollfd    pfd = {this->fd, POLLIN, 0};
+      const int rc  = poll(&pfd, 1, timeout);
+      if (rc < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        spdlog::error("Waiting for file changes failed: {}", std::strerror(errno));
+        break;
+      }
+      if (rc == 0) {
+        break;
+      }
+
+      const ssize_t len = read(this->fd, buf, sizeof(buf));
+      if (len <= 0) {
+        continue;
+      }
+      for (const char* ptr = buf; ptr < buf + len;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+        ptr += sizeof(inotify_event) + event->len;
+
+        const auto it = this->watchDescriptors.find(event->wd);
+        if (event->len == 0 || it == this->watchDescriptors.end()) {
+          continue;
+        }
+        const std::string path = (it->second / event->name).string();
+        if (this->files.find(path) != this->files.end()) {
+          changed.insert(path);
+        }
+      }
+
+      if (changed.size() > 0) {
+        timeout = debounce.count();
+      }
+    }
+    return std::vector<std::string>(changed.begin(), changed.end());
+  }
+#endif
+
+  // Polling fallback for platforms without inotify
+  while (changed.size() == 0) {
+    std::this_thread::sleep_for(std::max(debounce, std::chrono::milliseconds(250)));
+    for (auto& [path, mtime] : this->files) {
+      std::error_code ec;
+      const auto      current = std::filesystem::last_write_time(path, ec);
+      if (!ec && current != mtime) {
+        mtime = current;
+        changed.insert(path);
+      }
+    }
+  }
+  return std::vector<std::string>(changed.begin(), changed.end());
+}
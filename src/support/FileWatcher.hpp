@@ -0,0 +1,46 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace hdoc::utils {
+/// @brief Watches a set of files and reports when any of them change.
+///
+/// On Linux, inotify is used to monitor the parent directories of the watched files. Directories are watched
+/// instead of the files themselves because many editors save by renaming a temporary file over the original,
+/// which would silently drop a watch placed on the original file. Other platforms fall back to periodically
+/// polling the modification times of the watched files.
+class FileWatcher {
+public:
+  FileWatcher();
+  ~FileWatcher();
+  FileWatcher(const FileWatcher&)            = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  /// @brief Add a file to the set of watched files. Adding a file that is already watched does nothing.
+  void addFile(const std::filesystem::path& path);
+
+  /// @brief Returns the number of files that are being watched.
+  std::size_t size() const {
+    return this->files.size();
+  }
+
+  /// @brief Block until at least one watched file changes and return the paths of all the files that changed.
+  /// Changes that arrive within `debounce` of each other are coalesced into a single batch, so that saving
+  /// several files at once (or an editor writing a file in several steps) only triggers one rebuild.
+  std::vector<std::string> waitForChanges(const std::chrono::milliseconds debounce = std::chrono::milliseconds(100));
+
+private:
+  int                                                              fd = -1;           ///< inotify file descriptor
+  std::unordered_map<int, std::filesystem::path>                   watchDescriptors;  ///< inotify watch -> directory
+  std::unordered_set<std::string>                                  watchedDirs;       ///< Directories being watched
+  std::unordered_map<std::string, std::filesystem::file_time_type> files;             ///< Watched file -> mtime
+};
+} // namespace hdoc::utils
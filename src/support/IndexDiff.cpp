@@ -0,0 +1,34 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/IndexDiff.hpp"
+
+/// Add the differences between the symbols of one type in the old and new Indexes to diff
+template <typename T>
+static void diffDatabases(const hdoc::types::Database<T>& oldDB,
+                          const hdoc::types::Database<T>& newDB,
+                          hdoc::utils::IndexDiff&         diff) {
+  for (const auto& [id, s] : oldDB.entries) {
+    const auto it = newDB.entries.find(id);
+    if (it == newDB.entries.end()) {
+      diff.removed.push_back(id);
+    } else if (it->second.fingerprint != s.fingerprint) {
+      diff.changed.push_back(id);
+    }
+  }
+  for (const auto& [id, s] : newDB.entries) {
+    if (oldDB.entries.find(id) == oldDB.entries.end()) {
+      diff.added.push_back(id);
+    }
+  }
+}
+
+hdoc::utils::IndexDiff hdoc::utils::diffIndexes(const hdoc::types::Index& oldIndex,
+                                                const hdoc::types::Index& newIndex) {
+  IndexDiff diff;
+  diffDatabases(oldIndex.functions, newIndex.functions, diff);
+  diffDatabases(oldIndex.records, newIndex.records, diff);
+  diffDatabases(oldIndex.enums, newIndex.enums, diff);
+  diffDatabases(oldIndex.namespaces, newIndex.namespaces, diff);
+  return diff;
+}
@@ -0,0 +1,26 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <vector>
+
+#include "types/Index.hpp"
+
+namespace hdoc::utils {
+/// @brief The differences between two Indexes, by SymbolID
+struct IndexDiff {
+  std::vector<hdoc::types::SymbolID> added;   ///< Symbols that are only in the new Index
+  std::vector<hdoc::types::SymbolID> removed; ///< Symbols that are only in the old Index
+  std::vector<hdoc::types::SymbolID> changed; ///< Symbols in both Indexes whose fingerprints differ
+
+  /// @brief Returns the total number of differences
+  std::size_t size() const {
+    return this->added.size() + this->removed.size() + this->changed.size();
+  }
+};
+
+/// @brief Compare two Indexes using the fingerprints of their symbols, without looking at the symbols' contents.
+/// This takes linear time in the number of symbols.
+IndexDiff diffIndexes(const hdoc::types::Index& oldIndex, const hdoc::types::Index& newIndex);
+} // namespace hdoc::utils
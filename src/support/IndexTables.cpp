@@ -0,0 +1,277 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "llvm/Support/xxhash.h"
+
+#include "support/IndexTables.hpp"
+#include "support/TaskGroup.hpp"
+
+using SymbolIDTable = std::unordered_map<hdoc::types::SymbolID, std::vector<hdoc::types::SymbolID>>;
+
+/// Returns the lineage of a namespace or record, computing it from its parent's lineage first if needed
+static const std::vector<hdoc::types::SymbolID>&
+getLineage(const hdoc::types::Index& index, SymbolIDTable& lineages, const hdoc::types::SymbolID& id) {
+  if (const auto it = lineages.find(id); it != lineages.end()) {
+    return it->second;
+  }
+  // Claim the entry first so that a malformed cycle of parents ends here instead of recursing forever
+  lineages[id];
+
+  hdoc::types::SymbolID parentID;
+  if (const auto ns = index.namespaces.entries.find(id); ns != index.namespaces.entries.end()) {
+    parentID = ns->second.parentNamespaceID;
+  } else {
+    parentID = index.records.entries.at(id).parentNamespaceID;
+  }
+
+  std::vector<hdoc::types::SymbolID> lineage;
+  if (index.namespaces.entries.contains(parentID) || index.records.entries.contains(parentID)) {
+    lineage = getLineage(index, lineages, parentID);
+  }
+  lineage.push_back(id);
+  return lineages[id] = std::move(lineage);
+}
+
+/// Returns the records that a record inherits from, computing them from its base records' first if needed
+static const std::vector<hdoc::types::SymbolID>&
+getInheritedRecordIDs(const hdoc::types::Index& index, SymbolIDTable& inherited, const hdoc::types::SymbolID& id) {
+  if (const auto it = inherited.find(id); it != inherited.end()) {
+    return it->second;
+  }
+  inherited[id];
+
+  // Base records are visited from last to first, and each one's own bases are visited before the next one,
+  // which is the same order as a depth-first traversal using a stack
+  std::vector<hdoc::types::SymbolID> ids;
+  const auto&                        bases = index.records.entries.at(id).baseRecords;
+  for (auto base = bases.rbegin(); base != bases.rend(); ++base) {
+    // Records inherited privately are ignored and their parents are not traversed
+    if (index.records.entries.contains(base->id) == false || base->access == clang::AS_private) {
+      continue;
+    }
+    ids.push_back(base->id);
+    const auto& baseIDs = getInheritedRecordIDs(index, inherited, base->id);
+    ids.insert(ids.end(), baseIDs.begin(), baseIDs.end());
+  }
+  return inherited[id] = std::move(ids);
+}
+
+void hdoc::utils::computeAncestry(hdoc::types::Index& index, llvm::ThreadPool& pool) {
+  index.lineages.clear();
+  index.inheritedRecordIDs.clear();
+
+  // Every entry is built from the entries of its parent or base records, so each table takes a single pass over
+  // the Index. The two tables are independent, so they're built at the same time. Each pass isn't split any
+  // further, since an entry can't be built before the entries it's built from.
+  hdoc::utils::TaskGroup tasks(pool);
+  tasks.async([&]() {
+    for (const auto& [id, ns] : index.namespaces.entries) {
+      getLineage(index, index.lineages, id);
+    }
+    for (const auto& [id, c] : index.records.entries) {
+      getLineage(index, index.lineages, id);
+    }
+  });
+  tasks.async([&]() {
+    for (const auto& [id, c] : index.records.entries) {
+      getInheritedRecordIDs(index, index.inheritedRecordIDs, id);
+    }
+  });
+  tasks.wait();
+}
+
+/// Sort all of the entries in db by name, and record the rank of each one.
+/// Symbols with the same name are ordered by ID so that the order is the same from one run to the next.
+template <typename T> static void collate(hdoc::types::Database<T>& db) {
+  std::vector<std::pair<const std::string*, hdoc::types::SymbolID>> names;
+  names.reserve(db.entries.size());
+  for (const auto& [id, s] : db.entries) {
+    names.emplace_back(&s.name, id);
+  }
+  std::sort(names.begin(), names.end(), [](const auto& lhs, const auto& rhs) {
+    const int cmp = lhs.first->compare(*rhs.first);
+    return cmp < 0 || (cmp == 0 && lhs.second.raw() < rhs.second.raw());
+  });
+
+  db.sortedIDs.clear();
+  db.sortedIDs.reserve(names.size());
+  db.ranks.clear();
+  db.ranks.reserve(names.size());
+  for (const auto& [name, id] : names) {
+    db.ranks.emplace(id, db.sortedIDs.size());
+    db.sortedIDs.push_back(id);
+  }
+}
+
+void hdoc::utils::computeCollation(hdoc::types::Index& index, llvm::ThreadPool& pool) {
+  // Each type of symbol is sorted independently
+  hdoc::utils::TaskGroup tasks(pool);
+  tasks.async([&]() { collate(index.functions); });
+  tasks.async([&]() { collate(index.records); });
+  tasks.async([&]() { collate(index.enums); });
+  tasks.async([&]() { collate(index.namespaces); });
+  tasks.wait();
+}
+
+void hdoc::utils::pruneTypeRefs(hdoc::types::Index&                                       index,
+                                const std::vector<std::unique_ptr<hdoc::serde::TagFile>>& tagFiles) {
+  const auto pruneID = [&](hdoc::types::SymbolID& id, hdoc::types::SymbolID& unresolvedID, std::string& externalURL) {
+    // Start over from the ID the matchers found, since the record may have been added or removed since the last run
+    if (id.raw() == 0) {
+      id = unresolvedID;
+    }
+    unresolvedID = hdoc::types::SymbolID();
+    externalURL  = "";
+    if (id.raw() == 0 || index.records.contains(id)) {
+      return;
+    }
+    // Types that aren't in the Index may still be documented by another project
+    for (const auto& tags : tagFiles) {
+      if (const auto tag = tags->find(id); tag && tag->kind == hdoc::serde::TagKind::Record) {
+        externalURL = std::string(tag->url);
+        break;
+      }
+    }
+    unresolvedID = id;
+    id           = hdoc::types::SymbolID();
+  };
+  const auto pruneTypeRef = [&](hdoc::types::TypeRef& type) {
+    pruneID(type.id, type.unresolvedID, type.externalURL);
+    for (auto& token : type.tokens) {
+      pruneID(token.id, token.unresolvedID, token.externalURL);
+    }
+  };
+
+  for (auto& [k, v] : index.functions.entries) {
+    pruneTypeRef(v.returnType);
+    for (auto& param : v.params) {
+      pruneTypeRef(param.type);
+    }
+  }
+  for (auto& [k, v] : index.records.entries) {
+    for (auto& var : v.vars) {
+      pruneTypeRef(var.type);
+    }
+  }
+}
+
+std::vector<hdoc::types::SymbolID> hdoc::utils::resolveReverseReferences(hdoc::types::Index& index) {
+  // The matchers already store every type reference in the Index, so the reverse references are collected from
+  // there in a single pass instead of being recorded while parsing.
+  std::unordered_map<hdoc::types::SymbolID, std::vector<hdoc::types::SymbolID>> usedByFunctions;
+  std::unordered_map<hdoc::types::SymbolID, std::vector<hdoc::types::SymbolID>> usedByRecords;
+  const auto addReference = [&](auto& table, const hdoc::types::SymbolID& to, const hdoc::types::SymbolID& from) {
+    if (to.raw() != 0 && to.raw() != from.raw() && index.records.contains(to)) {
+      table[to].push_back(from);
+    }
+  };
+
+  for (const auto& [k, f] : index.functions.entries) {
+    addReference(usedByFunctions, f.returnType.id, f.ID);
+    for (const auto& param : f.params) {
+      addReference(usedByFunctions, param.type.id, f.ID);
+    }
+  }
+  for (const auto& [k, c] : index.records.entries) {
+    for (const auto& var : c.vars) {
+      addReference(usedByRecords, var.type.id, c.ID);
+    }
+    for (const auto& base : c.baseRecords) {
+      addReference(usedByRecords, base.id, c.ID);
+    }
+  }
+
+  // Sort and de-duplicate the lists so they can be compared with the previous ones
+  const auto normalize = [](std::vector<hdoc::types::SymbolID>& ids) {
+    const auto cmp = [](const hdoc::types::SymbolID& a, const hdoc::types::SymbolID& b) { return a.raw() < b.raw(); };
+    std::sort(ids.begin(), ids.end(), cmp);
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  };
+
+  std::vector<hdoc::types::SymbolID> changed;
+  for (auto& [k, c] : index.records.entries) {
+    std::vector<hdoc::types::SymbolID> functions;
+    std::vector<hdoc::types::SymbolID> records;
+    if (const auto it = usedByFunctions.find(c.ID); it != usedByFunctions.end()) {
+      functions = std::move(it->second);
+      normalize(functions);
+    }
+    if (const auto it = usedByRecords.find(c.ID); it != usedByRecords.end()) {
+      records = std::move(it->second);
+      normalize(records);
+    }
+    if (functions != c.usedByFunctionIDs || records != c.usedByRecordIDs) {
+      c.usedByFunctionIDs = std::move(functions);
+      c.usedByRecordIDs   = std::move(records);
+      changed.push_back(c.ID);
+    }
+  }
+  return changed;
+}
+
+/// Accumulates the documented fields of a symbol so they can be hashed into a fingerprint.
+/// Fields are separated by null characters so that moving text from one field to the next changes the fingerprint.
+class Fingerprint {
+public:
+  Fingerprint& add(const std::string_view str) {
+    this->buffer.append(str);
+    this->buffer.push_back('\0');
+    return *this;
+  }
+  Fingerprint& add(const int64_t value) {
+    return this->add(std::to_string(value));
+  }
+  Fingerprint& add(const hdoc::types::Symbol& s) {
+    return this->add(s.name).add(s.briefComment).add(s.docComment);
+  }
+  Fingerprint& add(const std::vector<hdoc::types::TemplateParam>& templateParams) {
+    for (const auto& t : templateParams) {
+      this->add(t.name).add(t.type).add(t.docComment).add(t.defaultValue);
+    }
+    return *this;
+  }
+  uint64_t hash() const {
+    return llvm::xxHash64(this->buffer);
+  }
+
+private:
+  std::string buffer;
+};
+
+void hdoc::utils::computeFingerprints(hdoc::types::Index& index) {
+  // Locations aren't part of the fingerprint, so that moving a symbol doesn't count as changing it
+  for (auto& [k, f] : index.functions.entries) {
+    Fingerprint fp;
+    fp.add(f).add(f.proto).add(f.access).add(f.isCtorOrDtor).add(f.returnTypeDocComment).add(f.templateParams);
+    for (const auto& param : f.params) {
+      fp.add(param.name).add(param.type.name).add(param.docComment).add(param.defaultValue);
+    }
+    f.fingerprint = fp.hash();
+  }
+  for (auto& [k, c] : index.records.entries) {
+    Fingerprint fp;
+    fp.add(c).add(c.proto).add(c.templateParams);
+    for (const auto& var : c.vars) {
+      fp.add(var.name).add(var.type.name).add(var.defaultValue).add(var.docComment).add(var.access).add(var.isStatic);
+    }
+    c.fingerprint = fp.hash();
+  }
+  for (auto& [k, e] : index.enums.entries) {
+    Fingerprint fp;
+    fp.add(e).add(e.type);
+    for (const auto& m : e.members) {
+      fp.add(m.name).add(m.value).add(m.docComment);
+    }
+    e.fingerprint = fp.hash();
+  }
+  for (auto& [k, n] : index.namespaces.entries) {
+    n.fingerprint = Fingerprint().add(n).hash();
+  }
+}
@@ -0,0 +1,38 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "llvm/Support/ThreadPool.h"
+
+#include <memory>
+#include <vector>
+
+#include "serde/TagFile.hpp"
+#include "types/Index.hpp"
+
+namespace hdoc::utils {
+/// @brief Fill out the lineage of every namespace and record in the Index, and the records that every record inherits
+/// from. These tables aren't serialized, so this must be run on every Index, whether it was built by the Indexer or
+/// loaded from an archive, after the parents and base records of its symbols are final.
+void computeAncestry(hdoc::types::Index& index, llvm::ThreadPool& pool);
+
+/// @brief Sort the symbols of each type in the Index by name, and give each one its rank. Like the ancestry tables,
+/// these aren't serialized, so this must be run on every Index after all of its symbols have been added or renamed.
+void computeCollation(hdoc::types::Index& index, llvm::ThreadPool& pool);
+
+/// @brief Remove the IDs of TypeRefs to records that aren't in the Index, so that pages don't link to pages that don't
+/// exist. The removed IDs are kept in unresolvedID, and restored if the record is in the Index the next time this is
+/// run, e.g. after re-indexing. Records that are documented by another project have the URL of their page in one of
+/// the tag files linked to instead.
+void pruneTypeRefs(hdoc::types::Index& index, const std::vector<std::unique_ptr<hdoc::serde::TagFile>>& tagFiles);
+
+/// @brief Fill out the "used by" lists of every record in the Index from the TypeRefs and base records that refer to
+/// it. Returns the IDs of the records whose lists changed since the last time this was run on the Index.
+std::vector<hdoc::types::SymbolID> resolveReverseReferences(hdoc::types::Index& index);
+
+/// @brief Compute the fingerprint of every symbol in the Index from its documented content, i.e. everything that's
+/// printed about it except for its location and the pages it links to. This must be run after all of the other
+/// passes, since they change the content of symbols.
+void computeFingerprints(hdoc::types::Index& index);
+} // namespace hdoc::utils
@@ -3,58 +3,65 @@
 
 #include "support/MarkdownConverter.hpp"
 
-#include <fstream>
+#include <cstdlib>
+#include <mutex>
 
 #include "cmark-gfm-core-extensions.h"
+#include "cmark-gfm.h"
+#include "spdlog/spdlog.h"
 
-hdoc::utils::MarkdownConverter::MarkdownConverter(const std::filesystem::path& mdPath) {
-  // Slurp Markdown file into a string for later conversion.
-  std::ifstream     ifs(mdPath);
-  const std::string content((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
-
-  // Ensure that GFM's table extension is loaded.
-  cmark_gfm_core_extensions_ensure_registered();
-  this->markdownParser                   = cmark_parser_new(CMARK_OPT_DEFAULT);
-  cmark_syntax_extension* tableExtension = cmark_find_syntax_extension("table");
-  if (tableExtension) {
-    cmark_parser_attach_syntax_extension(this->markdownParser, tableExtension);
-  } else {
-    spdlog::warn("Unable to locate Markdown table extension. Skipping Markdown file {}.", mdPath.string());
+/// A parser with GFM's table extension attached, which is reset by cmark after each document so it can be reused
+struct ThreadParser {
+  ThreadParser() {
+    // Registering the extensions isn't thread-safe, but using them once they're registered is
+    static std::once_flag registered;
+    std::call_once(registered, cmark_gfm_core_extensions_ensure_registered);
+
+    this->parser                           = cmark_parser_new(CMARK_OPT_DEFAULT);
+    cmark_syntax_extension* tableExtension = cmark_find_syntax_extension("table");
+    if (tableExtension == nullptr) {
+      spdlog::warn("Unable to locate Markdown table extension. Markdown files will be skipped.");
+      return;
+    }
+    this->hasTables = cmark_parser_attach_syntax_extension(this->parser, tableExtension);
+  }
+  ~ThreadParser() {
+    cmark_parser_free(this->parser);
+  }
+
+  cmark_parser* parser    = nullptr;
+  bool          hasTables = false;
+};
+
+hdoc::utils::MarkdownConverter::MarkdownConverter(const std::string_view markdown, const std::string_view name) {
+  thread_local ThreadParser p;
+  if (p.hasTables == false) {
     return;
   }
 
   // Parse the raw Markdown into nodes, and then render it into HTML.
-  cmark_parser_feed(this->markdownParser, content.c_str(), content.size());
-  this->markdownDoc = cmark_parser_finish(this->markdownParser);
-  if (!this->markdownDoc) {
-    spdlog::warn("Parsing of Markdown file {} failed. Skipping this file.", mdPath.string());
+  cmark_parser_feed(p.parser, markdown.data(), markdown.size());
+  cmark_node* markdownDoc = cmark_parser_finish(p.parser);
+  if (!markdownDoc) {
+    spdlog::warn("Parsing of Markdown file {} failed. Skipping this file.", name);
     return;
   }
 
   // Convert the Markdown nodes into HTML.
-  this->htmlBuf = cmark_render_html(this->markdownDoc, CMARK_OPT_DEFAULT, NULL);
+  this->htmlBuf = cmark_render_html(markdownDoc, CMARK_OPT_DEFAULT, NULL);
+  cmark_node_free(markdownDoc);
   if (!this->htmlBuf) {
-    spdlog::warn("Conversion of Markdown file {} to HTML failed. Skipping this file.", mdPath.string());
-    return;
+    spdlog::warn("Conversion of Markdown file {} to HTML failed. Skipping this file.", name);
   }
-
-  // Convert HTML into a string for later retrieval.
-  this->html        = std::string(this->htmlBuf);
-  this->initialized = true;
 }
 
 hdoc::utils::MarkdownConverter::~MarkdownConverter() {
-  cmark_parser_free(this->markdownParser);
-  cmark_node_free(this->markdownDoc);
   free(this->htmlBuf);
 }
 
-CTML::Node hdoc::utils::MarkdownConverter::getHTMLNode() const {
-  if (this->initialized == false) {
-    return CTML::Node();
+std::string_view hdoc::utils::MarkdownConverter::getHTML() const {
+  if (this->htmlBuf == nullptr) {
+    return "";
   }
-
-  CTML::Node main("main");
-  main.AppendRawHTML(this->html);
-  return main;
+  return this->htmlBuf;
 }
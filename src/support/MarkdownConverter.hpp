@@ -3,27 +3,27 @@
 
 #pragma once
 
-#include <filesystem>
-#include <string>
-
-#include "cmark-gfm.h"
-#include "ctml.hpp"
-#include "spdlog/spdlog.h"
+#include <string_view>
 
 namespace hdoc::utils {
 
-/// Converts a Markdown file to an HTML string using GitHub's fork of CommonMark.
-struct MarkdownConverter {
-  MarkdownConverter(const std::filesystem::path& mdPath);
+/// @brief Converts Markdown to HTML using GitHub's fork of CommonMark.
+///
+/// GFM's extensions are registered once per process, and each thread keeps a parser with the table extension attached
+/// which it reuses for every conversion, so any number of threads can convert Markdown at the same time.
+/// The HTML stays in the buffer cmark rendered it into, so it can be appended straight to a page without a copy.
+class MarkdownConverter {
+public:
+  /// @brief Convert markdown to HTML. name identifies the Markdown in log messages, e.g. its filename.
+  MarkdownConverter(const std::string_view markdown, const std::string_view name);
   ~MarkdownConverter();
+  MarkdownConverter(const MarkdownConverter&)            = delete;
+  MarkdownConverter& operator=(const MarkdownConverter&) = delete;
 
-  /// Get the HTML node containing the Markdown contents
-  CTML::Node getHTMLNode() const;
+  /// @brief Returns the HTML, or an empty string if the conversion failed. It's valid until the converter is destroyed.
+  std::string_view getHTML() const;
 
-  cmark_parser* markdownParser = nullptr;
-  cmark_node*   markdownDoc    = nullptr;
-  char*         htmlBuf        = nullptr;
-  std::string   html           = "";
-  bool          initialized    = false;
+private:
+  char* htmlBuf = nullptr;
 };
 } // namespace hdoc::utils
@@ -3,52 +3,213 @@
 
 #include "support/ParallelExecutor.hpp"
 #include "spdlog/spdlog.h"
+#include "support/TaskGroup.hpp"
 
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/Utils.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace {
+/// Wraps another FrontendAction and records all of the non-system files that the translation unit depends on.
+/// Paths are made absolute against the working directory of the compile command so that they can be matched
+/// against paths reported by the filesystem.
+class DependencyRecordingAction : public clang::WrapperFrontendAction {
+public:
+  DependencyRecordingAction(std::unique_ptr<clang::FrontendAction> wrapped, std::vector<std::string>& deps)
+      : clang::WrapperFrontendAction(std::move(wrapped)), deps(deps) {}
+
+protected:
+  bool BeginSourceFileAction(clang::CompilerInstance& CI) override {
+    // The preprocessor has already been created at this point, so the collector is attached to it directly
+    if (CI.hasPreprocessor()) {
+      this->collector->attachToPreprocessor(CI.getPreprocessor());
+    }
+    return clang::WrapperFrontendAction::BeginSourceFileAction(CI);
+  }
+
+  void EndSourceFileAction() override {
+    auto& fs = getCompilerInstance().getFileManager().getVirtualFileSystem();
+    for (const auto& dep : this->collector->getDependencies()) {
+      llvm::SmallString<256> path(dep);
+      if (fs.makeAbsolute(path)) {
+        continue;
+      }
+      llvm::sys::path::remove_dots(path, true);
+      this->deps.push_back(path.str().str());
+    }
+    clang::WrapperFrontendAction::EndSourceFileAction();
+  }
+
+private:
+  std::shared_ptr<clang::DependencyCollector> collector = std::make_shared<clang::DependencyCollector>();
+  std::vector<std::string>&                   deps;
+};
+
+/// Creates DependencyRecordingActions that wrap the actions created by another factory.
+class DependencyRecordingActionFactory : public clang::tooling::FrontendActionFactory {
+public:
+  DependencyRecordingActionFactory(clang::tooling::FrontendActionFactory& inner, std::vector<std::string>& deps)
+      : inner(inner), deps(deps) {}
+
+  std::unique_ptr<clang::FrontendAction> create() override {
+    return std::make_unique<DependencyRecordingAction>(this->inner.create(), this->deps);
+  }
+
+private:
+  clang::tooling::FrontendActionFactory& inner;
+  std::vector<std::string>&              deps;
+};
+} // namespace
+
+clang::tooling::ArgumentsAdjuster hdoc::indexer::getModuleCacheAdjuster(const std::string&              cachePath,
+                                                                        const std::vector<std::string>& prebuiltPaths) {
+  // Translation units adjusted by the same adjuster share a build session, so modules are validated at most once.
+  // The timestamp only has a resolution of one second, and modules validated during a session are only validated
+  // again in a session with a later timestamp, so each session starts at least a second after the previous one.
+  static std::atomic<int64_t> lastSession = 0;
+
+  const auto now =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  int64_t previous = lastSession.load();
+  int64_t session  = std::max<int64_t>(now, previous + 1);
+  while (lastSession.compare_exchange_weak(previous, session) == false) {
+    session = std::max<int64_t>(now, previous + 1);
+  }
+  const std::string timestamp = std::to_string(session);
+
+  return [=](const clang::tooling::CommandLineArguments& args, llvm::StringRef) {
+    bool usesClangModules = false;
+    bool usesCxxModules   = false;
+    for (const llvm::StringRef arg : args) {
+      usesClangModules |= arg == "-fmodules" || arg == "-fcxx-modules";
+      usesCxxModules |= arg.startswith("-std=c++2") || arg.startswith("-std=gnu++2") || arg == "-fmodules-ts" ||
+                        arg.startswith("-fmodule-file=") || arg.startswith("-fprebuilt-module-path");
+    }
+    if (usesClangModules == false && usesCxxModules == false) {
+      return args;
+    }
+
+    clang::tooling::CommandLineArguments adjusted;
+    for (const llvm::StringRef arg : args) {
+      // The build's module cache holds modules built by a different compiler, which would all be rejected anyway
+      if (arg.startswith("-fmodules-cache-path=") == false) {
+        adjusted.push_back(arg.str());
+      }
+    }
+    if (usesClangModules) {
+      adjusted.push_back("-fmodules-cache-path=" + cachePath);
+      adjusted.push_back("-fbuild-session-timestamp=" + timestamp);
+      adjusted.push_back("-fmodules-validate-once-per-build-session");
+    }
+    for (const auto& p : prebuiltPaths) {
+      adjusted.push_back("-fprebuilt-module-path=" + p);
+    }
+    return adjusted;
+  };
+}
+
 void hdoc::indexer::ParallelExecutor::execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action) {
+  std::vector<std::string> allFilesInCmpdb = this->cmpdb.getAllFiles();
+  if (this->debugLimitNumIndexedFiles > 0 && this->debugLimitNumIndexedFiles < allFilesInCmpdb.size()) {
+    allFilesInCmpdb.resize(this->debugLimitNumIndexedFiles);
+  }
+  this->execute(std::move(action), allFilesInCmpdb);
+}
+
+void hdoc::indexer::ParallelExecutor::execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action,
+                                              const std::vector<std::string>&                        files) {
   std::mutex mutex;
 
   // Add a counter to track progress
   uint32_t    i                = 0;
-  std::string totalNumFiles    = std::to_string(this->cmpdb.getAllFiles().size());
+  std::string totalNumFiles    = std::to_string(files.size());
   auto        incrementCounter = [&]() {
     std::unique_lock<std::mutex> lock(mutex);
     return ++i;
   };
 
-  std::vector<std::string> allFilesInCmpdb = this->cmpdb.getAllFiles();
+  hdoc::utils::TaskGroup tasks(this->pool);
+  for (const std::string& file : files) {
+    tasks.async([&, path = file] {
+      spdlog::info("[{}/{}] processing {}", incrementCounter(), totalNumFiles, path);
+      this->runOnFile(*action, path, mutex);
+    });
+  }
+  // Make sure all tasks have finished before resetting the working directory
+  tasks.wait();
+}
 
-  if (this->debugLimitNumIndexedFiles > 0) {
-    allFilesInCmpdb.resize(this->debugLimitNumIndexedFiles);
-    totalNumFiles = std::to_string(this->debugLimitNumIndexedFiles);
-  }
-
-  for (const std::string& file : allFilesInCmpdb) {
-    this->pool.async(
-        [&](const std::string path) {
-          spdlog::info("[{}/{}] processing {}", incrementCounter(), totalNumFiles, path);
-
-          // Each thread gets an independent copy of a VFS to allow different concurrent working directories
-          llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = llvm::vfs::createPhysicalFileSystem().release();
-          clang::tooling::ClangTool Tool(this->cmpdb, {path}, std::make_shared<clang::PCHContainerOperations>(), FS);
-
-          // Append argument adjusters so that system includes and others are picked up on
-          // TODO: determine if the -fsyntax-only flag actually does anything
-          Tool.appendArgumentsAdjuster(clang::tooling::getClangStripOutputAdjuster());
-          Tool.appendArgumentsAdjuster(clang::tooling::getClangStripDependencyFileAdjuster());
-          Tool.appendArgumentsAdjuster(clang::tooling::getClangSyntaxOnlyAdjuster());
-          for (const auto& arg : this->args) {
-            Tool.appendArgumentsAdjuster(arg);
-          }
-
-          // Run the tool and print an error message if something goes wrong
-          if (Tool.run(action.get())) {
-            spdlog::error("Failed to parse source file: {}", path);
-          }
-        },
-        file);
+void hdoc::indexer::ParallelExecutor::execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action,
+                                              hdoc::indexer::StreamingCompilationDatabase&           db) {
+  std::mutex mutex;
+
+  // The total number of files isn't known until scanning is finished, so only count the files found so far
+  uint32_t i         = 0;
+  uint32_t numFound  = 0;
+  auto     getCounts = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return std::make_pair(++i, numFound);
+  };
+
+  // Start processing files as soon as they're found instead of waiting for the whole database to be scanned
+  hdoc::utils::TaskGroup tasks(this->pool);
+  std::string            err;
+  const bool             ok = db.scan(err, [&](const std::string& file) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if (this->debugLimitNumIndexedFiles > 0 && numFound >= this->debugLimitNumIndexedFiles) {
+        return;
+      }
+      numFound++;
+    }
+    tasks.async([&, path = file] {
+      const auto [n, total] = getCounts();
+      spdlog::info("[{}/{}] processing {}", n, total, path);
+      this->runOnFile(*action, path, mutex);
+    });
+  });
+  if (!ok) {
+    spdlog::error("Failed to read the compilation database ({}). Only files found before the error are indexed.", err);
   }
   // Make sure all tasks have finished before resetting the working directory
-  this->pool.wait();
+  tasks.wait();
+}
+
+void hdoc::indexer::ParallelExecutor::runOnFile(clang::tooling::FrontendActionFactory& action,
+                                                const std::string&                     path,
+                                                std::mutex&                            mutex) {
+  // Each thread gets an independent copy of a VFS to allow different concurrent working directories
+  llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = llvm::vfs::createPhysicalFileSystem().release();
+  clang::tooling::ClangTool Tool(this->cmpdb, {path}, std::make_shared<clang::PCHContainerOperations>(), FS);
+
+  // Append argument adjusters so that system includes and others are picked up on
+  // TODO: determine if the -fsyntax-only flag actually does anything
+  Tool.appendArgumentsAdjuster(clang::tooling::getClangStripOutputAdjuster());
+  Tool.appendArgumentsAdjuster(clang::tooling::getClangStripDependencyFileAdjuster());
+  Tool.appendArgumentsAdjuster(clang::tooling::getClangSyntaxOnlyAdjuster());
+  for (const auto& arg : this->args) {
+    Tool.appendArgumentsAdjuster(arg);
+  }
+
+  // Run the tool and print an error message if something goes wrong
+  int rc = 0;
+  if (this->dependencies == nullptr) {
+    rc = Tool.run(&action);
+  } else {
+    std::vector<std::string>         deps = {path};
+    DependencyRecordingActionFactory recordingAction(action, deps);
+    rc = Tool.run(&recordingAction);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    (*this->dependencies)[path] = std::move(deps);
+  }
+  if (rc) {
+    spdlog::error("Failed to parse source file: {}", path);
+  }
 }
@@ -7,7 +7,27 @@
 #include "clang/Tooling/Execution.h"
 #include "llvm/Support/ThreadPool.h"
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "indexer/StreamingCompilationDatabase.hpp"
+
 namespace hdoc::indexer {
+/// @brief Map of translation unit path to the paths of all non-system files it depends on (including itself).
+using DependencyMap = std::unordered_map<std::string, std::vector<std::string>>;
+
+/// @brief Returns an ArgumentsAdjuster that makes translation units which use modules share a module cache.
+/// Translation units using Clang modules have their module cache moved to cachePath, which is shared by all
+/// translation units and persists across runs. Each adjuster starts a new build session, in which modules are only
+/// validated once instead of once per translation unit, so a new adjuster must be used every time translation units
+/// are parsed again after files change. Every session's timestamp is later than the previous session's, even if
+/// they start within the same second. Translation units using Clang or C++20 modules also search prebuiltPaths
+/// for prebuilt module files.
+clang::tooling::ArgumentsAdjuster getModuleCacheAdjuster(const std::string&              cachePath,
+                                                         const std::vector<std::string>& prebuiltPaths);
+
 /// @brief A cut-down reimplementation of clang's AllTUsToolExecutor.
 /// Removes everything we don't need, leaving a simple mechanism that executes
 /// a frontend action over all files in the compilation database.
@@ -15,18 +35,32 @@ class ParallelExecutor {
 public:
   /// Creates a parallel executor that will run over all files in the compilation database.
   /// Args holds ArgumentAdjusters that will be applied to the parser, typically includes header search paths.
+  /// If dependencies is not null, the files each translation unit depends on are recorded into it.
   ParallelExecutor(const clang::tooling::CompilationDatabase&            cmpdb,
                    const std::vector<clang::tooling::ArgumentsAdjuster>& args,
                    llvm::ThreadPool&                                     pool,
-                   const uint32_t                                        debugLimitNumIndexedFiles)
-      : cmpdb(cmpdb), args(args), pool(pool), debugLimitNumIndexedFiles(debugLimitNumIndexedFiles) {}
+                   const uint32_t                                        debugLimitNumIndexedFiles,
+                   DependencyMap*                                        dependencies = nullptr)
+      : cmpdb(cmpdb), args(args), pool(pool), debugLimitNumIndexedFiles(debugLimitNumIndexedFiles),
+        dependencies(dependencies) {}
 
+  /// Execute the action over all files in the compilation database.
   void execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action);
 
+  /// Execute the action over the given subset of files in the compilation database.
+  void execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action, const std::vector<std::string>& files);
+
+  /// Execute the action over all files in db, starting on each file as soon as db's scan finds it.
+  void execute(std::unique_ptr<clang::tooling::FrontendActionFactory> action, StreamingCompilationDatabase& db);
+
 private:
+  /// Run the action over a single file. mutex guards dependencies.
+  void runOnFile(clang::tooling::FrontendActionFactory& action, const std::string& path, std::mutex& mutex);
+
   const clang::tooling::CompilationDatabase&            cmpdb;
   const std::vector<clang::tooling::ArgumentsAdjuster>& args;
   llvm::ThreadPool&                                     pool;
   const uint32_t                                        debugLimitNumIndexedFiles = 0;
+  DependencyMap*                                        dependencies              = nullptr;
 };
 } // namespace hdoc::indexer
@@ -0,0 +1,217 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "support/SystemIncludes.hpp"
+
+#include "spdlog/spdlog.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/xxhash.h"
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+/// Compiler launchers which wrap the real compiler, e.g. `ccache clang++ -c foo.cpp`
+static bool isCompilerLauncher(const llvm::StringRef arg) {
+  const llvm::StringRef name = llvm::sys::path::stem(arg);
+  return name == "ccache" || name == "sccache" || name == "distcc" || name == "icecc";
+}
+
+std::optional<hdoc::utils::CompilerInvocation>
+hdoc::utils::getCompilerInvocation(const std::vector<std::string>& args, const std::string& directory) {
+  std::size_t i = 0;
+  while (i < args.size() && isCompilerLauncher(args[i])) {
+    i++;
+  }
+  if (i >= args.size()) {
+    return std::nullopt;
+  }
+
+  CompilerInvocation invocation;
+  invocation.compiler = args[i];
+
+  // Relative paths are relative to the directory the compile command runs in, not to hdoc's working directory
+  const llvm::StringRef compiler = args[i];
+  if (directory.empty() == false && compiler.find_first_of("/\\") != llvm::StringRef::npos &&
+      llvm::sys::path::is_relative(compiler)) {
+    llvm::SmallString<256> path(directory);
+    llvm::sys::path::append(path, compiler);
+    llvm::sys::path::remove_dots(path, true);
+    invocation.compiler = path.str().str();
+  }
+
+  for (i = i + 1; i < args.size(); i++) {
+    const llvm::StringRef arg = args[i];
+
+    // Flags whose value is a separate argument
+    if (arg == "-target" || arg == "--target" || arg == "--sysroot" || arg == "-isysroot" ||
+        arg == "--gcc-toolchain") {
+      invocation.flags.push_back(args[i]);
+      if (i + 1 < args.size()) {
+        invocation.flags.push_back(args[++i]);
+      }
+      continue;
+    }
+
+    // Flags that are self-contained or have their value joined to them
+    if (arg.startswith("-stdlib=") || arg.startswith("--target=") || arg.startswith("--sysroot=") ||
+        arg.startswith("-isysroot") || arg.startswith("--gcc-toolchain=") || arg == "-m32" || arg == "-m64" ||
+        arg == "-nostdinc" || arg == "-nostdinc++" || arg == "-nostdlibinc") {
+      invocation.flags.push_back(args[i]);
+    }
+  }
+  return invocation;
+}
+
+/// Run the compiler with flags that make it print its builtin include paths, and parse them from its output.
+static std::optional<std::vector<std::string>> probeSystemIncludePaths(const std::string&              compiler,
+                                                                      const std::vector<std::string>& flags) {
+  llvm::SmallString<64> tempFile;
+  if (const auto ec = llvm::sys::fs::createTemporaryFile("hdoc-system-includes-compiler-output", "", tempFile)) {
+    spdlog::error("Unable to create temporary directory to store system includes: {}.", ec.message());
+    return std::nullopt;
+  }
+  llvm::FileRemover tempFileRemove(tempFile);
+
+  // The following flags make the compiler dump its default include paths.
+  // This works on all clang and gcc versions we've tried, but it might break with a more exotic compiler.
+  // The actual output we care about goes to tempFile, and we use /dev/null as a stand-in for the file the compiler
+  // reads.
+  llvm::SmallVector<llvm::StringRef> compilerFlags = {compiler};
+  compilerFlags.append(flags.begin(), flags.end());
+  compilerFlags.append({"-E", "-Wp,-v", "-xc++", "/dev/null"});
+  llvm::Optional<llvm::StringRef> redirects[] = {llvm::None, {"/dev/null"}, {tempFile}}; // stdin, stdout, stderr
+
+  std::string errMsg = "";
+  int         rc     = llvm::sys::ExecuteAndWait(compiler, compilerFlags, llvm::None, redirects, 10, 0, &errMsg);
+  if (rc != 0) {
+    spdlog::error("Failed to determine the system include paths of {} ({}, {}).", compiler, rc, errMsg);
+    return std::nullopt;
+  }
+
+  auto buf = llvm::MemoryBuffer::getFile(tempFile);
+  if (!buf) {
+    spdlog::error("Failed to read compiler's default include paths.");
+    return std::nullopt;
+  }
+
+  llvm::StringRef                    compilerOutput = buf->get()->getBuffer();
+  llvm::SmallVector<llvm::StringRef> lines;
+  compilerOutput.split(lines, "\n");
+
+  std::vector<std::string> includePaths;
+  bool                     searchListFound = false;
+  for (const auto line : lines) {
+    // Keep looking if we haven't found the line that starts with  '#include "..." search starts here'.
+    if (searchListFound == false) {
+      searchListFound = line.contains("#include") && line.contains("search starts here:");
+    }
+
+    // If we have found the beginning of the include list, filter it to only lines that have include paths.
+    if (searchListFound == true) {
+      if (line.startswith(" ")) {
+        includePaths.push_back(std::string(line.trim()));
+      }
+    }
+
+    // Stop looking if we've found the end of the include list.
+    if (line.contains("End of search list.")) {
+      break;
+    }
+  }
+  return includePaths;
+}
+
+/// Find the system include paths of a compiler, using the on-disk cache if possible
+static std::optional<std::vector<std::string>>
+getSystemIncludePathsFromDisk(const hdoc::utils::CompilerInvocation& invocation) {
+  // Compilers named without a path separator are looked up in PATH, like a shell would
+  std::string compiler = invocation.compiler;
+  if (llvm::StringRef(compiler).find_first_of("/\\") == llvm::StringRef::npos) {
+    const auto compilerPath = llvm::sys::findProgramByName(compiler);
+    if (!compilerPath) {
+      spdlog::error("Unable to find compiler {} to determine its system include paths.", compiler);
+      return std::nullopt;
+    }
+    compiler = compilerPath.get();
+  }
+
+  llvm::sys::fs::file_status status;
+  if (const auto ec = llvm::sys::fs::status(compiler, status)) {
+    spdlog::error("Unable to find compiler {} to determine its system include paths: {}.", compiler, ec.message());
+    return std::nullopt;
+  }
+
+  // The key changes whenever the compiler is upgraded in place, so stale results are never used.
+  // It's stored in the cache file to guard against hash collisions.
+  std::string key = compiler + "\t" + std::to_string(status.getSize()) + "\t" +
+                    std::to_string(status.getLastModificationTime().time_since_epoch().count());
+  for (const auto& flag : invocation.flags) {
+    key += "\t" + flag;
+  }
+
+  llvm::SmallString<256> cachePath;
+  const bool             hasCacheDir = llvm::sys::path::cache_directory(cachePath);
+  if (hasCacheDir) {
+    llvm::sys::path::append(cachePath, "hdoc", "system-includes", llvm::utohexstr(llvm::xxHash64(key)) + ".txt");
+    if (auto buf = llvm::MemoryBuffer::getFile(cachePath)) {
+      llvm::SmallVector<llvm::StringRef> lines;
+      buf->get()->getBuffer().split(lines, "\n", -1, false);
+      if (lines.size() > 0 && lines[0] == key) {
+        spdlog::info("Using cached system include paths for {}.", compiler);
+        return std::vector<std::string>(lines.begin() + 1, lines.end());
+      }
+    }
+  }
+
+  const auto includePaths = probeSystemIncludePaths(compiler, invocation.flags);
+  if (!includePaths || hasCacheDir == false) {
+    return includePaths;
+  }
+
+  // Write to a unique temporary file and rename it into place, so that concurrent runs never see a partial file
+  std::error_code             ec;
+  const std::filesystem::path path(cachePath.str().str());
+  std::filesystem::create_directories(path.parent_path(), ec);
+  const std::filesystem::path tempPath = path.string() + "." + std::to_string(llvm::sys::Process::getProcessId());
+  {
+    std::ofstream out(tempPath);
+    out << key << "\n";
+    for (const auto& p : *includePaths) {
+      out << p << "\n";
+    }
+  }
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    spdlog::warn("Unable to cache system include paths to {}: {}.", path.string(), ec.message());
+    std::filesystem::remove(tempPath, ec);
+  }
+  return includePaths;
+}
+
+std::optional<std::vector<std::string>> hdoc::utils::getSystemIncludePaths(const CompilerInvocation& invocation) {
+  // Results are also remembered in memory, for when several projects are documented by the same process
+  static std::mutex                                                               memoMutex;
+  static std::unordered_map<std::string, std::optional<std::vector<std::string>>> memo;
+  std::string                                                                     memoKey = invocation.compiler;
+  for (const auto& flag : invocation.flags) {
+    memoKey += "\t" + flag;
+  }
+  {
+    std::lock_guard<std::mutex> lock(memoMutex);
+    if (const auto it = memo.find(memoKey); it != memo.end()) {
+      return it->second;
+    }
+  }
+  const auto                  includePaths = getSystemIncludePathsFromDisk(invocation);
+  std::lock_guard<std::mutex> lock(memoMutex);
+  memo[memoKey] = includePaths;
+  return includePaths;
+}
@@ -0,0 +1,32 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hdoc::utils {
+/// @brief Identifies a compiler and the flags that change where it searches for system headers.
+struct CompilerInvocation {
+  std::string              compiler; ///< Path to the compiler binary, or its name if it's to be looked up in PATH
+  std::vector<std::string> flags;    ///< Flags such as --target or -stdlib that affect the system include paths
+
+  bool operator==(const CompilerInvocation&) const = default;
+};
+
+/// @brief Extract the compiler and the include-relevant flags from a compile command's arguments.
+/// Compiler launchers such as ccache are skipped. A relative path to the compiler is made absolute against directory,
+/// the compile command's working directory, and a compiler given by name is kept as-is so that
+/// getSystemIncludePaths() can look it up in PATH. Returns std::nullopt if args doesn't name a compiler.
+std::optional<CompilerInvocation> getCompilerInvocation(const std::vector<std::string>& args,
+                                                        const std::string&              directory = "");
+
+/// @brief Returns the builtin include paths of a compiler, in search order. A compiler given by name is looked up in
+/// PATH, like a shell would.
+/// Results are cached in the user's cache directory, keyed by the compiler's path, size, modification time, and
+/// flags, so the compiler is only executed when it hasn't been seen before or has since been changed.
+/// Returns std::nullopt if the compiler couldn't be found or executed, or its output couldn't be parsed.
+std::optional<std::vector<std::string>> getSystemIncludePaths(const CompilerInvocation& invocation);
+} // namespace hdoc::utils
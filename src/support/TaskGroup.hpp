@@ -0,0 +1,54 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#pragma once
+
+#include "llvm/Support/ThreadPool.h"
+
+#include <future>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace hdoc::utils {
+/// @brief A set of tasks run on a ThreadPool that can be waited for without waiting for the pool's other tasks.
+/// ThreadPool::wait() only returns once the whole pool is idle, so a thread that waits with it while another thread
+/// keeps queueing tasks on the same pool, like when several projects are documented at once in batch mode, waits
+/// for those tasks too, and may never stop waiting.
+class TaskGroup {
+public:
+  explicit TaskGroup(llvm::ThreadPool& pool) : pool(pool) {}
+
+  /// @brief Wait for the tasks that are still running
+  ~TaskGroup() {
+    this->wait();
+  }
+  TaskGroup(const TaskGroup&)            = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /// @brief Run task on the pool as part of this group. Tasks can be added by several threads at once.
+  template <typename F> void async(F&& task) {
+    auto             future = this->pool.async(std::forward<F>(task));
+    std::scoped_lock lock(this->mutex);
+    this->futures.push_back(std::move(future));
+  }
+
+  /// @brief Block until every task added to this group so far has finished.
+  /// Must not be called from one of the pool's threads.
+  void wait() {
+    std::vector<std::shared_future<void>> pending;
+    {
+      std::scoped_lock lock(this->mutex);
+      pending.swap(this->futures);
+    }
+    for (const auto& future : pending) {
+      future.wait();
+    }
+  }
+
+private:
+  llvm::ThreadPool&                     pool;
+  std::mutex                            mutex;
+  std::vector<std::shared_future<void>> futures; ///< Futures of the tasks that haven't been waited for
+};
+} // namespace hdoc::utils
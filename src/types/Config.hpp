@@ -5,6 +5,7 @@
 
 #include <filesystem>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace hdoc::types {
@@ -19,25 +20,40 @@ enum class BinaryType {
 
 /// @brief Stores configuration data that hdoc uses for indexing and serialization
 struct Config {
-  bool                     initialized       = false; ///< Is this object initialized?
-  bool                     useSystemIncludes = true;  ///< Use system compiler include paths by default
-  uint32_t                 numThreads        = 0; ///< Number of threads to be used during indexing (0 == all available)
-  BinaryType               binaryType        = hdoc::types::BinaryType::Full; ///< What type of hdoc is this?
+  bool                     initialized         = false; ///< Is this object initialized?
+  bool                     useSystemIncludes   = true;  ///< Use system compiler include paths by default
+  bool                     perTUSystemIncludes = false; ///< Derive system includes from each compile command's compiler
+  bool                     shardPages          = false; ///< Put symbol pages in subdirectories named after their IDs
+  uint32_t                 numThreads          = 0; ///< Number of threads used during indexing (0 == all available)
+  uint32_t                 renderThreads       = 0; ///< Number of threads used to write pages (0 == same as indexing)
+  BinaryType               binaryType          = hdoc::types::BinaryType::Full; ///< What type of hdoc is this?
   std::filesystem::path    rootDir;                      ///< Path to the root of the repo directory where .hdoc.toml is
   std::filesystem::path    compileCommandsJSON;          ///< Path to compile_commands.json
   std::filesystem::path    outputDir;                    ///< Path of where documentation is saved
   std::string              projectName;                  ///< Name of the project
   std::string              projectVersion;               ///< Project version
-  std::string              timestamp;                    ///< Timestamp of this run
+  std::string              timestamp;                    ///< Timestamp from SOURCE_DATE_EPOCH, if it's set
   std::string              hdocVersion;                  ///< hdoc git commit hash
   std::string              gitRepoURL;                   ///< URL prefix of a GitHub or GitLab repo for source links
   std::vector<std::string> includePaths;                 ///< Include paths passed on to Clang
   std::vector<std::string> ignorePaths;                  ///< Paths from which matches should be ignored
+  std::filesystem::path    moduleCachePath;              ///< Directory where Clang modules are cached between runs
+  std::vector<std::string> prebuiltModulePaths;          ///< Directories containing prebuilt module files
+  std::vector<std::filesystem::path> tagFiles;           ///< Tag files of other projects to link to
+  std::filesystem::path    tagFileExportPath;            ///< Where to write this project's tag file, if anywhere
+  std::string              tagFileBaseURL;               ///< URL where this project's documentation is hosted
   bool                     ignorePrivateMembers = false; ///< Should private members of records be ignored?
+  bool                     publicAPIOnly        = false; ///< Only index symbols declared in public headers?
+  std::vector<std::filesystem::path> publicAPIRoots;     ///< Directories containing the public headers
   std::filesystem::path    homepage;                     ///< Path to "homepage" markdown file
   std::vector<std::filesystem::path> mdPaths;            ///< Paths to markdown pages
+  std::unordered_map<std::string, std::string> mdContents; ///< Markdown pages that only exist in memory, by path
+  std::filesystem::path    archivePath;                  ///< Where to save the serialized Index, if anywhere
+  std::filesystem::path    outputArchive;                ///< Tar archive to write pages to instead ("-" = stdout)
 
   uint32_t debugLimitNumIndexedFiles; ///< Limit the number of files to index (0 == index all files)
+  bool     watch = false; ///< Keep running and rebuild documentation incrementally when source files change
+  uint16_t servePort = 0; ///< Port of the preview server started by `hdoc serve`, or 0 to write the documentation
 
   /// @brief Returns a string with the form "PROJECT_NAME PROJECT_VERSION documentation"
   /// if this->projectVersion has a value, otherwise returns "PROJECT_NAME documentation".
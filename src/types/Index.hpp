@@ -14,15 +14,17 @@
 namespace hdoc::types {
 /// @brief Stores values for a given type of Symbol
 template <typename T> struct Database {
-  std::atomic<uint32_t>                        numMatches = 0; ///< Number of matches
-  std::unordered_map<hdoc::types::SymbolID, T> entries;        ///< Hashmap that stores the entries
+  std::atomic<uint32_t>                        numMatches    = 0; ///< Number of matches
+  std::atomic<uint32_t>                        numDuplicates = 0; ///< Matches not extracted since already indexed
+  std::unordered_map<hdoc::types::SymbolID, T> entries;           ///< Hashmap that stores the entries
 
-  /// @brief Reserve a space for the given SymbolID, to be updated later
-  T& reserve(const hdoc::types::SymbolID& id) {
+  /// @brief Claim the given SymbolID by reserving an empty entry for it, to be filled in later with update().
+  /// Returns false if the SymbolID was already claimed, in which case the caller must not extract the symbol.
+  bool claim(const hdoc::types::SymbolID& id) {
     this->mutex.lock();
-    this->entries.insert(std::make_pair(id, T()));
+    bool res = this->entries.try_emplace(id).second;
     this->mutex.unlock();
-    return this->entries[id];
+    return res;
   }
 
   /// @brief Update the entry for a given SymbolID
@@ -40,6 +42,10 @@ template <typename T> struct Database {
     return res;
   }
 
+  // Filled out by hdoc::utils::computeCollation() after indexing or deserializing is done, and not serialized
+  std::vector<hdoc::types::SymbolID>                  sortedIDs; ///< IDs of all entries, sorted by name
+  std::unordered_map<hdoc::types::SymbolID, uint32_t> ranks;     ///< Position of each entry in sortedIDs
+
   /// Locks the database during operations that may cause mutations
   mutable std::mutex mutex;
 };
@@ -50,5 +56,17 @@ struct Index {
   Database<hdoc::types::RecordSymbol>    records;
   Database<hdoc::types::EnumSymbol>      enums;
   Database<hdoc::types::NamespaceSymbol> namespaces;
+
+  // The tables below are derived from the symbols above by hdoc::utils::computeAncestry() after indexing is done, or
+  // after the Index is loaded from an archive, so that pages can be rendered without walking the Index for every
+  // page. They aren't serialized.
+
+  /// For every namespace and record, the IDs of the namespaces and records enclosing it, outermost first and
+  /// ending with the symbol itself. A symbol's breadcrumbs are the lineage of its parent.
+  std::unordered_map<hdoc::types::SymbolID, std::vector<hdoc::types::SymbolID>> lineages;
+
+  /// For every record, the IDs of the records it inherits from that are in the Index, in depth-first order.
+  /// Records that are inherited privately are left out, along with everything they inherit from.
+  std::unordered_map<hdoc::types::SymbolID, std::vector<hdoc::types::SymbolID>> inheritedRecordIDs;
 };
 } // namespace hdoc::types
@@ -51,6 +51,18 @@ struct SymbolID {
   uint64_t hashValue = 0; ///< USR value hashed into an integer
 };
 
+/// @brief Returns the path of a symbol's page relative to the output directory, i.e. "r0123456789ABCDEF.html".
+/// kind is the page's prefix: 'f' for functions, 'r' for records, 'e' for enums, and 'n' for namespaces.
+/// If sharded, the page is put in a subdirectory named after the first two hex digits of its ID instead, i.e.
+/// "01/r0123456789ABCDEF.html", so that no directory has more than a few thousand pages.
+inline std::string pageURL(const char kind, const SymbolID& id, const bool sharded) {
+  const std::string str = id.str();
+  if (sharded) {
+    return str.substr(0, 2) + "/" + kind + str + ".html";
+  }
+  return kind + str + ".html";
+}
+
 /// @brief Base class for all other types of symbols
 struct Symbol {
   std::string           name;              ///< Function name, record name, enum name etc.
@@ -60,6 +72,7 @@ struct Symbol {
   std::string           file;              ///< File where this Symbol is declared, relative to source root
   std::uint64_t         line;              ///< Line number in the file
   hdoc::types::SymbolID parentNamespaceID; ///< ID of the parent namespace (or record)
+  uint64_t              fingerprint = 0;   ///< Hash of the documented content, to detect when the symbol changes
 
   /// @brief Comparison operator sorts alphabetically by symbol name
   bool operator<(const Symbol& s) const {
@@ -69,9 +82,23 @@ struct Symbol {
 
 /// @brief Represents a possible reference to another Symbol that may or may not be in the Index.
 /// Used to represent cross-links to function parameters, return types, or record member variables.
+/// IDs of records that aren't in the Index are moved to unresolvedID by hdoc::utils::pruneTypeRefs(), so that they're
+/// linked again if the record is added back when re-indexing. unresolvedID isn't serialized.
 struct TypeRef {
-  hdoc::types::SymbolID id;   ///< Possible SymbolID of this type.
-  std::string           name; ///< Name of the type
+  /// @brief A name inside the type that can be linked to, e.g. "std::vector" and "MyType" in "std::vector<MyType> &"
+  struct Token {
+    uint64_t              start        = 0;  ///< Offset of the name in TypeRef::name
+    uint64_t              length       = 0;  ///< Length of the name, including any qualifiers like "std::"
+    hdoc::types::SymbolID id           = {}; ///< SymbolID of the named record, or empty if it isn't in the Index
+    std::string           externalURL  = ""; ///< URL of the record's page in another project's docs, from a tag file
+    hdoc::types::SymbolID unresolvedID = {}; ///< SymbolID of the named record while it isn't in the Index
+  };
+
+  hdoc::types::SymbolID id;                ///< Possible SymbolID of this type.
+  std::string           name;              ///< Name of the type
+  std::string           externalURL  = ""; ///< URL of the type's page in another project's docs, from a tag file
+  std::vector<Token>    tokens       = {}; ///< Linkable names in the type, in the order they appear in name
+  hdoc::types::SymbolID unresolvedID = {}; ///< SymbolID of this type while it isn't in the Index
 };
 
 /// @brief Represents a function parameter
@@ -110,15 +137,17 @@ struct RecordSymbol : public Symbol {
     std::string            name;   ///< Name of the record, used only for base records in std:: which aren't indexed
   };
 
-  std::string                        type;           ///< i.e. struct/class/union
-  std::string                        proto;          ///< Full class prototype, including
-  std::vector<MemberVariable>        vars;           ///< All of this record's member variables
-  std::vector<hdoc::types::SymbolID> methodIDs;      ///< All of this record's methods
-  std::vector<BaseRecord>            baseRecords;    ///< All of the records this record inherits from
-  std::vector<TemplateParam>         templateParams; ///< All of the template parameters for this record
-
-  std::string url() const {
-    return "r" + this->ID.str() + ".html";
+  std::string                        type;              ///< i.e. struct/class/union
+  std::string                        proto;             ///< Full class prototype, including
+  std::vector<MemberVariable>        vars;              ///< All of this record's member variables
+  std::vector<hdoc::types::SymbolID> methodIDs;         ///< All of this record's methods
+  std::vector<BaseRecord>            baseRecords;       ///< All of the records this record inherits from
+  std::vector<TemplateParam>         templateParams;    ///< All of the template parameters for this record
+  std::vector<hdoc::types::SymbolID> usedByFunctionIDs; ///< Functions and methods that take or return this record
+  std::vector<hdoc::types::SymbolID> usedByRecordIDs;   ///< Records that contain or inherit from this record
+
+  std::string url(const bool sharded) const {
+    return pageURL('r', this->ID, sharded);
   }
 };
 
@@ -156,8 +185,8 @@ public:
   std::vector<FunctionParam> params;               ///< All of the template parameters for this function
   std::vector<TemplateParam> templateParams;       ///< All of the parameters for this function
 
-  std::string url() const {
-    return "f" + this->ID.str() + ".html";
+  std::string url(const bool sharded) const {
+    return pageURL('f', this->ID, sharded);
   }
 };
 
@@ -174,8 +203,8 @@ public:
   std::string             type = ""; ///< "class" for enum class, "struct" for enum struct, otherwise ""
   std::vector<EnumMember> members;   ///< All of this enum's values
 
-  std::string url() const {
-    return "e" + this->ID.str() + ".html";
+  std::string url(const bool sharded) const {
+    return pageURL('e', this->ID, sharded);
   }
 };
 
@@ -186,8 +215,8 @@ public:
   std::vector<hdoc::types::SymbolID> namespaces = {}; ///< All of the other namespaces in this namespace
   std::vector<hdoc::types::SymbolID> enums      = {}; ///< All of the enums in this namespace
 
-  std::string url() const {
-    return "n" + this->ID.str() + ".html";
+  std::string url(const bool sharded) const {
+    return pageURL('n', this->ID, sharded);
   }
 };
 
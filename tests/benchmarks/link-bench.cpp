@@ -0,0 +1,100 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+// Compares the time it takes to escape and hyperlink type names with repeated replaceAll() and replaceFirst()
+// passes and with the single-pass getHyperlinkedTypeName().
+// Usage: link-bench [number of passes over the corpus]
+
+#include "spdlog/spdlog.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../unit-tests/TypeNames.hpp"
+#include "serde/CppReferenceURLs.hpp"
+#include "serde/HTMLWriter.hpp"
+#include "serde/PrototypeFormatter.hpp"
+#include "support/StringUtils.hpp"
+#include "types/Symbols.hpp"
+
+/// Turn the corpus into type references, linking a third of them to indexed records and a third to a tag file
+static std::vector<hdoc::types::TypeRef> makeTypes() {
+  std::vector<hdoc::types::TypeRef> types(typeNameCases.size());
+  for (uint64_t i = 0; i < typeNameCases.size(); i++) {
+    types[i].name = typeNameCases[i].input;
+    if (i % 3 == 0) {
+      types[i].id = hdoc::types::SymbolID(types[i].name);
+    } else if (i % 3 == 1) {
+      types[i].externalURL = "https://example.com/" + std::to_string(i) + ".html";
+    }
+  }
+  return types;
+}
+
+/// The previous implementation: escape with one replaceAll() per character, then replace the first bare type name
+static std::string linkReplace(const hdoc::types::TypeRef& type) {
+  const std::string bareTypeName = hdoc::serde::getBareTypeName(type.name);
+  std::string       str          = hdoc::serde::formatTypeName(type.name);
+  str                            = hdoc::utils::replaceAll(str, "&", "&amp;");
+  str                            = hdoc::utils::replaceAll(str, "<", "&lt;");
+  str                            = hdoc::utils::replaceAll(str, ">", "&gt;");
+  str                            = hdoc::utils::replaceAll(str, "\"", "&quot;");
+  str                            = hdoc::utils::replaceAll(str, "'", "&apos;");
+
+  std::string url;
+  if (type.id.raw() != 0) {
+    url = "r" + type.id.str() + ".html";
+  } else if (type.externalURL != "") {
+    url = type.externalURL;
+  } else if (bareTypeName.starts_with("std::") && StdTypeURLMap.find(bareTypeName) != StdTypeURLMap.end()) {
+    url = std::string(cppreferenceURL) + StdTypeURLMap.at(bareTypeName);
+  }
+  if (url != "") {
+    hdoc::utils::replaceFirst(str, bareTypeName, "<a href=\"" + url + "\">" + bareTypeName + "</a>");
+  }
+  return str;
+}
+
+/// The current implementation, with pages in a flat output directory
+static std::string linkSinglePass(const hdoc::types::TypeRef& type) {
+  return hdoc::serde::getHyperlinkedTypeName(type);
+}
+
+/// Link every type passes times, returning the time taken in milliseconds and the output's total size
+template <typename F>
+static std::pair<double, uint64_t>
+bench(const std::vector<hdoc::types::TypeRef>& types, const uint64_t passes, F link) {
+  uint64_t   totalSize = 0;
+  const auto start     = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < passes; i++) {
+    for (const auto& type : types) {
+      totalSize += link(type).size();
+    }
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return {std::chrono::duration<double, std::milli>(end - start).count(), totalSize};
+}
+
+int main(int argc, char** argv) {
+  const uint64_t passes = argc > 1 ? std::stoull(argv[1]) : 100;
+  const auto     types  = makeTypes();
+
+  // Both implementations must produce exactly the same HTML for the comparison to be meaningful.
+  // This also warms up formatTypeName()'s cache so that neither is charged for formatting.
+  for (const auto& type : types) {
+    const std::string a = linkReplace(type);
+    const std::string b = linkSinglePass(type);
+    if (a != b) {
+      spdlog::error("replaceAll and single-pass output differ for {}:\n{}\n{}", type.name, a, b);
+      return 1;
+    }
+  }
+
+  const auto [replaceTime, replaceSize] = bench(types, passes, linkReplace);
+  const auto [kernelTime, kernelSize]   = bench(types, passes, linkSinglePass);
+  spdlog::info("Linked {} type names {} times ({} bytes)", types.size(), passes, replaceSize);
+  spdlog::info("replaceAll:  {:.1f} ms", replaceTime);
+  spdlog::info("Single-pass: {:.1f} ms ({:.1f}x faster)", kernelTime, replaceTime / kernelTime);
+  return replaceSize == kernelSize ? 0 : 1;
+}
@@ -0,0 +1,74 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+// Measures the time it takes HTMLWriter to render function pages, keeping them in memory so that the filesystem
+// isn't part of the measurement.
+// Usage: render-bench [number of functions]
+
+#include "spdlog/spdlog.h"
+#include "llvm/Support/ThreadPool.h"
+
+#include <chrono>
+#include <string>
+
+#include "serde/HTMLWriter.hpp"
+#include "support/IndexTables.hpp"
+#include "types/Config.hpp"
+#include "types/Index.hpp"
+#include "types/Symbols.hpp"
+
+/// Add n functions with a comment and a few parameters each, similar to what's found in a typical project
+static void addFunctions(hdoc::types::Index& index, const uint64_t n) {
+  for (uint64_t i = 0; i < n; i++) {
+    hdoc::types::FunctionSymbol f;
+    f.name         = "function" + std::to_string(i);
+    f.ID           = hdoc::types::SymbolID(f.name);
+    f.returnType   = {hdoc::types::SymbolID(), "std::vector<int>"};
+    f.proto        = "std::vector<int> " + f.name + "(const Widget & w, int count = 0)";
+    f.nameStart    = 17;
+    f.briefComment = "Returns the first count <values> of w & its children";
+    f.file         = "include/widgets/" + f.name + ".hpp";
+    f.line         = i;
+    f.params.push_back({"w", {hdoc::types::SymbolID(), "const Widget &"}, "The widget to use", ""});
+    f.params.push_back({"count", {hdoc::types::SymbolID(), "int"}, "How many values to return", "0"});
+    index.functions.update(f.ID, f);
+  }
+}
+
+int main(int argc, char** argv) {
+  const uint64_t numFunctions = argc > 1 ? std::stoull(argv[1]) : 100000;
+  if (numFunctions == 0) {
+    spdlog::error("The number of functions to render must be at least 1.");
+    return 1;
+  }
+
+  hdoc::types::Index index;
+  addFunctions(index, numFunctions);
+  llvm::ThreadPool pool(llvm::hardware_concurrency(1));
+  hdoc::utils::computeCollation(index, pool);
+
+  // Pages are kept in memory, like they are when previewing the documentation
+  hdoc::types::Config cfg;
+  cfg.projectName = "render-bench";
+  cfg.servePort   = 8000;
+  cfg.outputDir   = "render-bench-output";
+  const hdoc::serde::HTMLWriter writer(&index, &cfg, pool);
+
+  uint64_t   totalSize = 0;
+  const auto start     = std::chrono::steady_clock::now();
+  for (const auto& id : index.functions.sortedIDs) {
+    const auto& f    = index.functions.entries.at(id);
+    const auto  page = writer.renderPage(f.url(false));
+    if (page.has_value() == false || page->find(f.name) == std::string::npos) {
+      spdlog::error("The page of {} wasn't rendered.", f.name);
+      return 1;
+    }
+    totalSize += page->size();
+  }
+  const auto   end  = std::chrono::steady_clock::now();
+  const double time = std::chrono::duration<double, std::milli>(end - start).count();
+
+  spdlog::info("Rendered {} function pages ({} bytes)", numFunctions, totalSize);
+  spdlog::info("{:.1f} ms, {:.1f} us per page", time, time * 1000 / numFunctions);
+  return 0;
+}
@@ -2,8 +2,14 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 
 #include "common.hpp"
+#include "support/IndexTables.hpp"
 #include "types/Config.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
 TEST_CASE("Class member") {
   const std::string code = R"(
     class Foo {
@@ -255,3 +261,141 @@ TEST_CASE("Checking that private members aren't indexed when they're not wanted"
   CHECK(s.baseRecords.size() == 0);
   CHECK(s.templateParams.size() == 0);
 }
+
+TEST_CASE("Public API only mode only indexes symbols declared in headers under the public API roots") {
+  // Headers need to be real files so that they have paths to compare against the roots
+  const std::filesystem::path dir = std::filesystem::weakly_canonical(std::filesystem::temp_directory_path()) /
+                                    "hdoc-test-public-api";
+  std::filesystem::create_directories(dir / "include");
+  std::filesystem::create_directories(dir / "src");
+  std::ofstream(dir / "include" / "api.hpp") << "class Widget {};\nvoid draw(Widget w);\n";
+  std::ofstream(dir / "src" / "detail.hpp") << "struct Helper {};\nenum class Mode { A, B };\n";
+
+  const std::string code = "#include \"" + (dir / "include" / "api.hpp").string() + "\"\n" + "#include \"" +
+                           (dir / "src" / "detail.hpp").string() + "\"\n" + R"(
+    class Foo {
+    public:
+      void bar();
+    };
+    void baz(Foo f);
+    enum class Qux { A, B };
+  )";
+
+  hdoc::types::Config cfg;
+  cfg.publicAPIOnly  = true;
+  cfg.publicAPIRoots = {dir / "include"};
+  hdoc::types::Index index;
+  runOverCode(code, index, cfg);
+  std::filesystem::remove_all(dir);
+
+  // Symbols in the public headers are kept, while those in the source file and in other headers are dropped
+  checkIndexSizes(index, 1, 1, 0, 0);
+  CHECK(findByName(index.records, "Widget").has_value());
+  CHECK(findByName(index.functions, "draw").has_value());
+  CHECK(findByName(index.records, "Helper").has_value() == false);
+  CHECK(findByName(index.records, "Foo").has_value() == false);
+}
+
+TEST_CASE("Records list the functions and records that use them") {
+  const std::string code = R"(
+    struct Point {};
+    struct Shape {
+      Point origin;
+    };
+    struct Circle : Shape {
+      int radius;
+    };
+    struct Unused {};
+    Point center(const Shape& s);
+    void draw(Circle c, Point p);
+  )";
+
+  hdoc::types::Index index;
+  runOverCode(code, index);
+  checkIndexSizes(index, 4, 2, 0, 0);
+
+  const auto point  = findByName(index.records, "Point");
+  const auto shape  = findByName(index.records, "Shape");
+  const auto circle = findByName(index.records, "Circle");
+  const auto unused = findByName(index.records, "Unused");
+  const auto center = findByName(index.functions, "center");
+  const auto draw   = findByName(index.functions, "draw");
+  REQUIRE(point.has_value());
+  REQUIRE(shape.has_value());
+  REQUIRE(circle.has_value());
+  REQUIRE(unused.has_value());
+  REQUIRE(center.has_value());
+  REQUIRE(draw.has_value());
+
+  // The lists are sorted by SymbolID, and so is the list of changed records
+  const auto sorted = [](std::vector<hdoc::types::SymbolID> ids) {
+    std::sort(ids.begin(), ids.end(), [](const auto& a, const auto& b) { return a.raw() < b.raw(); });
+    return ids;
+  };
+
+  // Every record that's used is reported as changed the first time
+  CHECK(sorted(hdoc::utils::resolveReverseReferences(index)) == sorted({point->ID, shape->ID, circle->ID}));
+  CHECK(index.records.entries.at(point->ID).usedByFunctionIDs == sorted({center->ID, draw->ID}));
+  CHECK(index.records.entries.at(point->ID).usedByRecordIDs == sorted({shape->ID}));
+  CHECK(index.records.entries.at(shape->ID).usedByFunctionIDs == sorted({center->ID}));
+  CHECK(index.records.entries.at(shape->ID).usedByRecordIDs == sorted({circle->ID}));
+  CHECK(index.records.entries.at(circle->ID).usedByFunctionIDs == sorted({draw->ID}));
+  CHECK(index.records.entries.at(circle->ID).usedByRecordIDs.size() == 0);
+  CHECK(index.records.entries.at(unused->ID).usedByFunctionIDs.size() == 0);
+  CHECK(index.records.entries.at(unused->ID).usedByRecordIDs.size() == 0);
+
+  // Nothing changes if the Index is the same
+  CHECK(hdoc::utils::resolveReverseReferences(index).size() == 0);
+
+  // Only the records that draw() used are reported after it's removed
+  index.functions.entries.erase(draw->ID);
+  CHECK(sorted(hdoc::utils::resolveReverseReferences(index)) == sorted({point->ID, circle->ID}));
+  CHECK(index.records.entries.at(point->ID).usedByFunctionIDs == sorted({center->ID}));
+  CHECK(index.records.entries.at(point->ID).usedByRecordIDs == sorted({shape->ID}));
+  CHECK(index.records.entries.at(circle->ID).usedByFunctionIDs.size() == 0);
+}
+
+TEST_CASE("Types are linked again when the records they name are added back to the Index") {
+  const std::string code = R"(
+    struct Widget {};
+    struct Gadget {
+      Widget part;
+    };
+    Widget make();
+  )";
+
+  hdoc::types::Index index;
+  runOverCode(code, index);
+  checkIndexSizes(index, 2, 1, 0, 0);
+
+  const auto widget = findByName(index.records, "Widget");
+  const auto gadget = findByName(index.records, "Gadget");
+  const auto make   = findByName(index.functions, "make");
+  REQUIRE(widget.has_value());
+  REQUIRE(gadget.has_value());
+  REQUIRE(make.has_value());
+
+  const auto& returnType = index.functions.entries.at(make->ID).returnType;
+  const auto& partType   = index.records.entries.at(gadget->ID).vars.at(0).type;
+  REQUIRE(returnType.tokens.size() == 1);
+  hdoc::utils::pruneTypeRefs(index, {});
+  CHECK(returnType.id == widget->ID);
+  CHECK(returnType.tokens[0].id == widget->ID);
+  CHECK(partType.id == widget->ID);
+
+  // Types naming a record that was removed aren't linked
+  index.records.entries.erase(widget->ID);
+  hdoc::utils::pruneTypeRefs(index, {});
+  CHECK(returnType.id.raw() == 0);
+  CHECK(returnType.unresolvedID == widget->ID);
+  CHECK(returnType.tokens[0].id.raw() == 0);
+  CHECK(partType.id.raw() == 0);
+
+  // They're linked again once it's back, as happens when the file declaring it is re-indexed
+  index.records.update(widget->ID, *widget);
+  hdoc::utils::pruneTypeRefs(index, {});
+  CHECK(returnType.id == widget->ID);
+  CHECK(returnType.unresolvedID.raw() == 0);
+  CHECK(returnType.tokens[0].id == widget->ID);
+  CHECK(partType.id == widget->ID);
+}
@@ -0,0 +1,73 @@
+// Copyright 2019-2022 hdoc
+// SPDX-License-Identifier: AGPL-3.0-only
+
+#include "common.hpp"
+
+#include "llvm/Support/ThreadPool.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "indexer/Indexer.hpp"
+
+TEST_CASE("Re-indexing a changed file reports the symbols that were updated and removed") {
+  const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hdoc-test-reindex";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  // Each header is part of a different translation unit, so only one of them is parsed again
+  std::ofstream(dir / "circle.hpp") << "namespace shapes { struct Circle {}; }\nnamespace legacy { void draw(); }\n";
+  std::ofstream(dir / "square.hpp") << "namespace shapes { struct Square {}; }\n";
+  std::ofstream(dir / "circle.cpp") << "#include \"circle.hpp\"\n";
+  std::ofstream(dir / "square.cpp") << "#include \"square.hpp\"\n";
+  const auto command = [&](const std::string& file) {
+    return "{\"directory\": \"" + dir.string() + "\", \"file\": \"" + file + "\", \"command\": \"clang++ -c " + file +
+           "\"}";
+  };
+  std::ofstream(dir / "compile_commands.json") << "[" << command("circle.cpp") << ", " << command("square.cpp")
+                                               << "]\n";
+
+  hdoc::types::Config cfg;
+  cfg.rootDir                   = dir;
+  cfg.compileCommandsJSON       = dir / "compile_commands.json";
+  cfg.useSystemIncludes         = false;
+  cfg.debugLimitNumIndexedFiles = 0;
+  cfg.watch                     = true;
+
+  llvm::ThreadPool       pool(llvm::hardware_concurrency(2));
+  hdoc::indexer::Indexer indexer(&cfg, pool);
+  indexer.run();
+  checkIndexSizes(*indexer.dump(), 2, 1, 0, 2);
+  const auto oldCircle = findByName(indexer.dump()->records, "Circle");
+  const auto draw      = findByName(indexer.dump()->functions, "draw");
+  const auto legacy    = findByName(indexer.dump()->namespaces, "legacy");
+  const auto shapes    = findByName(indexer.dump()->namespaces, "shapes");
+  REQUIRE(oldCircle);
+  REQUIRE(draw);
+  REQUIRE(legacy);
+  REQUIRE(shapes);
+
+  // Circle moves out of shapes, and legacy is no longer declared anywhere.
+  // shapes is still declared in square.hpp, which isn't parsed again, so it's kept.
+  std::ofstream(dir / "circle.hpp") << "struct Circle { int radius; };\n";
+  const auto delta = indexer.reindex({(dir / "circle.hpp").string()});
+  checkIndexSizes(*indexer.dump(), 2, 0, 0, 1);
+  CHECK(indexer.dump()->namespaces.contains(shapes->ID));
+
+  const auto newCircle = findByName(indexer.dump()->records, "Circle");
+  REQUIRE(newCircle);
+  CHECK(newCircle->ID != oldCircle->ID);
+  CHECK(std::find(delta.updated.begin(), delta.updated.end(), newCircle->ID) != delta.updated.end());
+
+  const auto wasRemoved = [&](const hdoc::types::SymbolID& id) {
+    return std::find(delta.removed.begin(), delta.removed.end(), id) != delta.removed.end();
+  };
+  CHECK(delta.removed.size() == 3);
+  CHECK(wasRemoved(oldCircle->ID));
+  CHECK(wasRemoved(draw->ID));
+  CHECK(wasRemoved(legacy->ID));
+
+  std::filesystem::remove_all(dir);
+}
@@ -686,6 +686,43 @@ TEST_CASE("Function that takes specialized template argument with pointer has co
   CHECK(f.params[0].defaultValue == "");
 }
 
+TEST_CASE("Records named in a parameter's template arguments are recorded as tokens") {
+  const std::string code = R"(
+    template<class T>
+    class TemplatedClass {};
+
+    struct Arg {};
+
+    void function(const TemplatedClass<Arg> & arg) {}
+  )";
+
+  hdoc::types::Index index;
+  runOverCode(code, index);
+  checkIndexSizes(index, 2, 1, 0, 0);
+
+  hdoc::types::SymbolID templatedClassID;
+  hdoc::types::SymbolID argID;
+  for (const auto& [id, s] : index.records.entries) {
+    if (s.name == "TemplatedClass") {
+      templatedClassID = id;
+    } else if (s.name == "Arg") {
+      argID = id;
+    }
+  }
+
+  hdoc::types::FunctionSymbol f = index.functions.entries.begin()->second;
+  CHECK(f.params.size() == 1);
+  CHECK(f.params[0].type.name == "const TemplatedClass<Arg> &");
+  CHECK(f.params[0].type.id == templatedClassID);
+  CHECK(f.params[0].type.tokens.size() == 2);
+  CHECK(f.params[0].type.tokens[0].start == 6);
+  CHECK(f.params[0].type.tokens[0].length == 14);
+  CHECK(f.params[0].type.tokens[0].id == templatedClassID);
+  CHECK(f.params[0].type.tokens[1].start == 21);
+  CHECK(f.params[0].type.tokens[1].length == 3);
+  CHECK(f.params[0].type.tokens[1].id == argID);
+}
+
 // TODO: figure out why there are 3 CXXMethodDecls in this code block
 // TEST_CASE("what the fuck") {
 //   const std::string code = R"(